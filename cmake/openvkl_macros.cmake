@@ -202,22 +202,21 @@ macro(openvkl_install_target name)
   )
 endmacro()
 
-# Generate files that deal with the VDB topology.
-# There are "templatized" files for traversal, for example,
-# and we also define constants that describe the topology
-# in terms of node resolution per level.
-function(openvkl_vdb_generate_topology)
+# Generate the headers that define the given VDB topology (a list of
+# per-level base-2 log resolutions, root first) in the given directory,
+# relative to the binary directory.
+function(openvkl_vdb_generate_topology_headers LOG_RESOLUTION DIRECTORY)
 
-  list(LENGTH VKL_VDB_LOG_RESOLUTION VKL_VDB_NUM_LEVELS)
+  list(LENGTH LOG_RESOLUTION VKL_VDB_NUM_LEVELS)
   math(EXPR VKL_VDB_LEAF_LEVEL "${VKL_VDB_NUM_LEVELS}-1")
-  list(REVERSE VKL_VDB_LOG_RESOLUTION) # Define from leaf level up.
+  list(REVERSE LOG_RESOLUTION) # Define from leaf level up.
   set(VKL_VDB_TOTAL_LOG_RES 0)
 
   foreach(I RANGE ${VKL_VDB_LEAF_LEVEL})
     math(EXPR VKL_VDB_LEVEL "${VKL_VDB_LEAF_LEVEL}-${I}")
     math(EXPR VKL_VDB_NEXT_LEVEL "${VKL_VDB_LEVEL}+1")
 
-    list(GET VKL_VDB_LOG_RESOLUTION ${I} VKL_VDB_LEVEL_LOG_RES)
+    list(GET LOG_RESOLUTION ${I} VKL_VDB_LEVEL_LOG_RES)
     math(EXPR VKL_VDB_LEVEL_STORAGE_RES "(1<<${VKL_VDB_LEVEL_LOG_RES})")
     math(EXPR VKL_VDB_LEVEL_NUM_VOXELS "(1<<(3*${VKL_VDB_LEVEL_LOG_RES}))")
     math(EXPR VKL_VDB_TOTAL_LOG_RES "(${VKL_VDB_TOTAL_LOG_RES}+${VKL_VDB_LEVEL_LOG_RES})")
@@ -230,26 +229,97 @@ function(openvkl_vdb_generate_topology)
 
     configure_file(
       ${PROJECT_SOURCE_DIR}/${PROJECT_NAME}/include/${PROJECT_NAME}/vdb_topology.h.in
-      include/${PROJECT_NAME}/vdb/topology${VKL_VDB_POSTFIX}.h
+      ${DIRECTORY}/topology${VKL_VDB_POSTFIX}.h
     )
+  endforeach(I)
+
+endfunction()
+
+# Generate files that deal with the VDB topology.
+# There are "templatized" files for traversal, for example,
+# and we also define constants that describe the topology
+# in terms of node resolution per level.
+#
+# VKL_VDB_LOG_RESOLUTION is the default topology, and defines the public
+# constants in openvkl/vdb.h. VKL_VDB_EXTRA_LOG_RESOLUTIONS lists additional
+# topologies that volumes may select at runtime. The ISPC driver compiles
+# its VDB sampling and traversal code once for each entry in
+# VKL_VDB_TOPOLOGIES, which this function sets in the parent scope.
+function(openvkl_vdb_generate_topology)
+
+  openvkl_vdb_generate_topology_headers("${VKL_VDB_LOG_RESOLUTION}"
+    include/${PROJECT_NAME}/vdb)
+
+  string(REPLACE ";" "," VKL_VDB_DEFAULT_TOPOLOGY "${VKL_VDB_LOG_RESOLUTION}")
+  set(VKL_VDB_TOPOLOGIES ${VKL_VDB_DEFAULT_TOPOLOGY} ${VKL_VDB_EXTRA_LOG_RESOLUTIONS})
+  list(REMOVE_DUPLICATES VKL_VDB_TOPOLOGIES)
+
+  set(VKL_VDB_MAX_NUM_LEVELS 0)
+  set(VKL_VDB_ITERATE_TOPOLOGIES "")
+  set(VKL_VDB_TOPOLOGY 0)
+  foreach(TOPOLOGY ${VKL_VDB_TOPOLOGIES})
+    string(REPLACE "," ";" TOPOLOGY_LOG_RESOLUTION "${TOPOLOGY}")
+    list(LENGTH TOPOLOGY_LOG_RESOLUTION TOPOLOGY_NUM_LEVELS)
+    if (TOPOLOGY_NUM_LEVELS LESS 2)
+      message(FATAL_ERROR "VDB topology ${TOPOLOGY} must have at least two levels")
+    endif()
+    # Iterator state is sized for this (see iterator_size.h).
+    if (TOPOLOGY_NUM_LEVELS GREATER 6)
+      message(FATAL_ERROR "VDB topology ${TOPOLOGY} must have at most six levels")
+    endif()
+    if (TOPOLOGY_NUM_LEVELS GREATER VKL_VDB_MAX_NUM_LEVELS)
+      set(VKL_VDB_MAX_NUM_LEVELS ${TOPOLOGY_NUM_LEVELS})
+    endif()
+
+    openvkl_vdb_generate_topology_headers("${TOPOLOGY_LOG_RESOLUTION}"
+      include/${PROJECT_NAME}_vdb/topology_${VKL_VDB_TOPOLOGY})
+
+    string(APPEND VKL_VDB_ITERATE_TOPOLOGIES " Macro(${VKL_VDB_TOPOLOGY})")
+    math(EXPR VKL_VDB_TOPOLOGY "${VKL_VDB_TOPOLOGY}+1")
+  endforeach()
+  set(VKL_VDB_NUM_TOPOLOGIES ${VKL_VDB_TOPOLOGY})
+
+  configure_file(
+    ${PROJECT_SOURCE_DIR}/${PROJECT_NAME}/drivers/ispc/volume/vdb/VdbTopologies.h.in
+    include/${PROJECT_NAME}_vdb/VdbTopologies.h
+  )
+
+  # Traversal code only depends on the level, so we generate it once for
+  # all levels of the deepest topology.
+  math(EXPR VKL_VDB_MAX_LEVEL "${VKL_VDB_MAX_NUM_LEVELS}-1")
+  foreach(VKL_VDB_LEVEL RANGE ${VKL_VDB_MAX_LEVEL})
+    math(EXPR VKL_VDB_NEXT_LEVEL "${VKL_VDB_LEVEL}+1")
+
+    set(VKL_VDB_POSTFIX "")
+    if (${VKL_VDB_LEVEL} GREATER 0)
+      set(VKL_VDB_POSTFIX "_${VKL_VDB_LEVEL}")
+    endif()
+
     configure_file(
       ${PROJECT_SOURCE_DIR}/${PROJECT_NAME}/drivers/ispc/volume/vdb/VdbSampleConstantLeaf.ih.in
       include/${PROJECT_NAME}_vdb/VdbSampleConstantLeaf_${VKL_VDB_LEVEL}.ih
     )
 
-    configure_file(
-      ${PROJECT_SOURCE_DIR}/${PROJECT_NAME}/drivers/ispc/volume/vdb/VdbSamplerDispatchInner.ih.in
-      include/${PROJECT_NAME}_vdb/VdbSamplerDispatchInner${VKL_VDB_POSTFIX}.ih
-    )
+    # Traversal code is generated for 32 bit and 64 bit voxel offsets.
+    foreach(VKL_VDB_ADDRESS_BITS 32 64)
+      set(VKL_VDB_ADDRESS_TYPE "uint${VKL_VDB_ADDRESS_BITS}")
 
-    foreach(VKL_VDB_UNIVARY in "uniform" "varying")
       configure_file(
-        ${PROJECT_SOURCE_DIR}/${PROJECT_NAME}/drivers/ispc/volume/vdb/VdbSampleInner.ih.in
-        include/${PROJECT_NAME}_vdb/VdbSampleInner_${VKL_VDB_UNIVARY}_${VKL_VDB_LEVEL}.ih
+        ${PROJECT_SOURCE_DIR}/${PROJECT_NAME}/drivers/ispc/volume/vdb/VdbSamplerDispatchInner.ih.in
+        include/${PROJECT_NAME}_vdb/VdbSamplerDispatchInner_${VKL_VDB_ADDRESS_BITS}${VKL_VDB_POSTFIX}.ih
       )
+
+      foreach(VKL_VDB_UNIVARY in "uniform" "varying")
+        configure_file(
+          ${PROJECT_SOURCE_DIR}/${PROJECT_NAME}/drivers/ispc/volume/vdb/VdbSampleInner.ih.in
+          include/${PROJECT_NAME}_vdb/VdbSampleInner_${VKL_VDB_UNIVARY}_${VKL_VDB_ADDRESS_BITS}_${VKL_VDB_LEVEL}.ih
+        )
+      endforeach()
     endforeach()
 
-  endforeach(I)
+  endforeach(VKL_VDB_LEVEL)
+
+  set(VKL_VDB_TOPOLOGIES ${VKL_VDB_TOPOLOGIES} PARENT_SCOPE)
 
 endfunction()
 
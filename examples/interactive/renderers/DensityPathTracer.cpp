@@ -56,34 +56,54 @@ namespace openvkl {
                                            float &sample,
                                            float &transmittance)
     {
-      t = hits.lower;
+      // Woodcock tracking with a separate majorant for each interval. The
+      // value selector carries the transfer function opacities, and
+      // intervals without opacity are skipped entirely.
+      VKLIntervalIterator iterator;
+      vklInitIntervalIterator(&iterator,
+                              scene.volume,
+                              (const vkl_vec3f *)&ray.org,
+                              (const vkl_vec3f *)&ray.dir,
+                              (const vkl_range1f *)&hits,
+                              scene.valueSelector);
 
-      const float sigmaMax = sigmaTScale;
+      VKLInterval interval;
 
-      while (true) {
-        vec2f randomNumbers = rng.getFloats();
+      while (vklIterateInterval(&iterator, &interval)) {
+        // The majorant is infinite without a transfer function, but
+        // opacities never exceed 1.
+        const float sigmaMax = sigmaTScale * min(interval.majorant, 1.f);
 
-        t = t + -std::log(1.f - randomNumbers.x) / sigmaMax;
+        if (sigmaMax <= 0.f)
+          continue;
 
-        if (t > hits.upper) {
-          transmittance = 1.f;
-          return false;
-        }
+        t = interval.tRange.lower;
+
+        while (true) {
+          vec2f randomNumbers = rng.getFloats();
+
+          t = t + -std::log(1.f - randomNumbers.x) / sigmaMax;
 
-        const vec3f c = ray.org + t * ray.dir;
-        sample        = vklComputeSample(scene.volume, (const vkl_vec3f *)&c);
+          if (t > interval.tRange.upper)
+            break;
 
-        vec4f sampleColorAndOpacity = sampleTransferFunction(scene, sample);
+          const vec3f c = ray.org + t * ray.dir;
+          sample = vklComputeSample(scene.volume, (const vkl_vec3f *)&c);
 
-        // sigmaT must be mono-chromatic for Woodcock sampling
-        const float sigmaTSample = sigmaMax * sampleColorAndOpacity.w;
+          vec4f sampleColorAndOpacity = sampleTransferFunction(scene, sample);
 
-        if (randomNumbers.y < sigmaTSample / sigmaMax)
-          break;
+          // sigmaT must be mono-chromatic for Woodcock sampling
+          const float sigmaTSample = sigmaTScale * sampleColorAndOpacity.w;
+
+          if (randomNumbers.y < sigmaTSample / sigmaMax) {
+            transmittance = 0.f;
+            return true;
+          }
+        }
       }
 
-      transmittance = 0.f;
-      return true;
+      transmittance = 1.f;
+      return false;
     }
 
     void DensityPathTracer::integrate(RNG &rng,
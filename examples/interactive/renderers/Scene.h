@@ -76,6 +76,17 @@ struct Scene
                                 valueRanges.size(),
                                 (const vkl_range1f *)valueRanges.data());
 
+      // the transfer function opacities provide per interval majorants
+      std::vector<float> opacities;
+      for (const vec4f &c : transferFunction.colorsAndOpacities)
+        opacities.push_back(c.w);
+
+      vklValueSelectorSetTransferFunction(
+          valueSelector,
+          (const vkl_range1f *)&transferFunction.valueRange,
+          opacities.size(),
+          opacities.data());
+
       // if we have isovalues, set these values on the value selector
       if (!isoValues.empty()) {
         vklValueSelectorSetValues(
@@ -155,7 +155,7 @@ void usage(const char *progname)
                "\t-gridDimensions <dimX> <dimY> <dimZ>\n"
                "\t-voxelType uchar | short | ushort | float | double\n"
                "\t-file <float.raw>\n"
-               "\t-filter nearest | trilinear (vdb only)\n"
+               "\t-filter nearest | trilinear | tricubic (vdb only)\n"
                "\t-field <density> (vdb only)\n"
             << std::endl;
 }
@@ -262,6 +262,8 @@ int main(int argc, const char **argv)
         filter = VKL_FILTER_TRILINEAR;
       else if (filterArg == "nearest")
         filter = VKL_FILTER_NEAREST;
+      else if (filterArg == "tricubic")
+        filter = VKL_FILTER_TRICUBIC;
       else
         throw std::runtime_error("unsupported -filter specified");
     } else if (switchArg == "-renderer") {
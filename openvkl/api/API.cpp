@@ -285,6 +285,30 @@ OPENVKL_CATCH_END()
 // Interval iterator //////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+extern "C" size_t vklGetIntervalIteratorSize(VKLVolume volume)
+    OPENVKL_CATCH_BEGIN
+{
+  THROW_IF_NULL_OBJECT(volume);
+  return openvkl::api::currentDriver().getIntervalIteratorSize(volume, 1);
+}
+OPENVKL_CATCH_END(0)
+
+#define __define_vklGetIntervalIteratorSizeN(WIDTH)                      \
+  extern "C" size_t vklGetIntervalIteratorSize##WIDTH(VKLVolume volume)  \
+      OPENVKL_CATCH_BEGIN                                                \
+  {                                                                      \
+    THROW_IF_NULL_OBJECT(volume);                                        \
+    return openvkl::api::currentDriver().getIntervalIteratorSize(volume, \
+                                                                 WIDTH); \
+  }                                                                      \
+  OPENVKL_CATCH_END(0)
+
+__define_vklGetIntervalIteratorSizeN(4);
+__define_vklGetIntervalIteratorSizeN(8);
+__define_vklGetIntervalIteratorSizeN(16);
+
+#undef __define_vklGetIntervalIteratorSizeN
+
 extern "C" void vklInitIntervalIterator(VKLIntervalIterator *iterator,
                                         VKLVolume volume,
                                         const vkl_vec3f *origin,
@@ -367,10 +391,99 @@ __define_vklIterateIntervalN(16);
 
 #undef __define_vklIterateIntervalN
 
+extern "C" void vklGetIntervalIteratorCheckpoint(
+    const VKLIntervalIterator *iterator,
+    VKLIntervalIteratorCheckpoint *checkpoint) OPENVKL_CATCH_BEGIN
+{
+  THROW_IF_NULL(iterator, "iterator");
+  THROW_IF_NULL(checkpoint, "checkpoint");
+  openvkl::api::currentDriver().getIntervalIteratorCheckpoint1(
+      reinterpret_cast<const vVKLIntervalIteratorN<1> &>(*iterator),
+      *checkpoint);
+}
+OPENVKL_CATCH_END()
+
+extern "C" void vklResumeIntervalIterator(
+    VKLIntervalIterator *iterator,
+    VKLVolume volume,
+    const vkl_vec3f *origin,
+    const vkl_vec3f *direction,
+    const vkl_range1f *tRange,
+    const VKLIntervalIteratorCheckpoint *checkpoint,
+    VKLValueSelector valueSelector) OPENVKL_CATCH_BEGIN
+{
+  THROW_IF_NULL(checkpoint, "checkpoint");
+  openvkl::api::currentDriver().resumeIntervalIterator1(
+      reinterpret_cast<vVKLIntervalIteratorN<1> &>(*iterator),
+      volume,
+      reinterpret_cast<const vvec3fn<1> &>(*origin),
+      reinterpret_cast<const vvec3fn<1> &>(*direction),
+      reinterpret_cast<const vrange1fn<1> &>(*tRange),
+      *checkpoint,
+      valueSelector);
+}
+OPENVKL_CATCH_END()
+
+extern "C" void vklIterateIntervalStream(VKLVolume volume,
+                                         size_t numRays,
+                                         const vkl_vec3f *origins,
+                                         const vkl_vec3f *directions,
+                                         const vkl_range1f *tRanges,
+                                         VKLValueSelector valueSelector,
+                                         size_t maxIntervalsPerRay,
+                                         VKLInterval *intervals,
+                                         uint32_t *numIntervals)
+    OPENVKL_CATCH_BEGIN
+{
+  THROW_IF_NULL_OBJECT(volume);
+  if (numRays == 0)
+    return;
+  THROW_IF_NULL(origins, "origins");
+  THROW_IF_NULL(directions, "directions");
+  THROW_IF_NULL(intervals, "intervals");
+  THROW_IF_NULL(numIntervals, "numIntervals");
+  if (maxIntervalsPerRay == 0)
+    throw std::runtime_error("maxIntervalsPerRay must be positive");
+  openvkl::api::currentDriver().iterateIntervalStream(volume,
+                                                      numRays,
+                                                      origins,
+                                                      directions,
+                                                      tRanges,
+                                                      valueSelector,
+                                                      maxIntervalsPerRay,
+                                                      intervals,
+                                                      numIntervals);
+}
+OPENVKL_CATCH_END()
+
 ///////////////////////////////////////////////////////////////////////////////
 // Hit iterator ///////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+extern "C" size_t vklGetHitIteratorSize(VKLVolume volume)
+    OPENVKL_CATCH_BEGIN
+{
+  THROW_IF_NULL_OBJECT(volume);
+  return openvkl::api::currentDriver().getHitIteratorSize(volume, 1);
+}
+OPENVKL_CATCH_END(0)
+
+#define __define_vklGetHitIteratorSizeN(WIDTH)                      \
+  extern "C" size_t vklGetHitIteratorSize##WIDTH(VKLVolume volume)  \
+      OPENVKL_CATCH_BEGIN                                           \
+  {                                                                 \
+    THROW_IF_NULL_OBJECT(volume);                                   \
+    return openvkl::api::currentDriver().getHitIteratorSize(volume, \
+                                                            WIDTH); \
+  }                                                                 \
+  OPENVKL_CATCH_END(0)
+
+__define_vklGetHitIteratorSizeN(4);
+__define_vklGetHitIteratorSizeN(8);
+__define_vklGetHitIteratorSizeN(16);
+
+#undef __define_vklGetHitIteratorSizeN
+
 extern "C" void vklInitHitIterator(VKLHitIterator *iterator,
                                    VKLVolume volume,
                                    const vkl_vec3f *origin,
@@ -416,6 +529,55 @@ __define_vklInitHitIteratorN(16);
 
 #undef __define_vklInitHitIteratorN
 
+extern "C" void vklInitHitIteratorTime(VKLHitIterator *iterator,
+                                       VKLVolume volume,
+                                       const vkl_vec3f *origin,
+                                       const vkl_vec3f *direction,
+                                       const vkl_range1f *tRange,
+                                       float time,
+                                       VKLValueSelector valueSelector)
+    OPENVKL_CATCH_BEGIN
+{
+  return openvkl::api::currentDriver().initHitIteratorTime1(
+      reinterpret_cast<vVKLHitIteratorN<1> &>(*iterator),
+      volume,
+      reinterpret_cast<const vvec3fn<1> &>(*origin),
+      reinterpret_cast<const vvec3fn<1> &>(*direction),
+      reinterpret_cast<const vrange1fn<1> &>(*tRange),
+      &time,
+      valueSelector);
+}
+OPENVKL_CATCH_END()
+
+#define __define_vklInitHitIteratorTimeN(WIDTH)                      \
+  extern "C" void vklInitHitIteratorTime##WIDTH(                     \
+      const int *valid,                                              \
+      VKLHitIterator##WIDTH *iterator,                               \
+      VKLVolume volume,                                              \
+      const vkl_vvec3f##WIDTH *origin,                               \
+      const vkl_vvec3f##WIDTH *direction,                            \
+      const vkl_vrange1f##WIDTH *tRange,                             \
+      const float *times,                                            \
+      VKLValueSelector valueSelector) OPENVKL_CATCH_BEGIN            \
+  {                                                                  \
+    return openvkl::api::currentDriver().initHitIteratorTime##WIDTH( \
+        valid,                                                       \
+        reinterpret_cast<vVKLHitIteratorN<WIDTH> &>(*iterator),      \
+        volume,                                                      \
+        reinterpret_cast<const vvec3fn<WIDTH> &>(*origin),           \
+        reinterpret_cast<const vvec3fn<WIDTH> &>(*direction),        \
+        reinterpret_cast<const vrange1fn<WIDTH> &>(*tRange),         \
+        times,                                                       \
+        valueSelector);                                              \
+  }                                                                  \
+  OPENVKL_CATCH_END()
+
+__define_vklInitHitIteratorTimeN(4);
+__define_vklInitHitIteratorTimeN(8);
+__define_vklInitHitIteratorTimeN(16);
+
+#undef __define_vklInitHitIteratorTimeN
+
 extern "C" int vklIterateHit(VKLHitIterator *iterator,
                              VKLHit *hit) OPENVKL_CATCH_BEGIN
 {
@@ -604,6 +766,47 @@ extern "C" void vklValueSelectorSetValues(VKLValueSelector valueSelector,
 }
 OPENVKL_CATCH_END()
 
+extern "C" void vklValueSelectorSetTransferFunction(
+    VKLValueSelector valueSelector,
+    const vkl_range1f *valueRange,
+    size_t numOpacities,
+    const float *opacities) OPENVKL_CATCH_BEGIN
+{
+  ASSERT_DRIVER();
+  THROW_IF_NULL(valueRange, "value range");
+  openvkl::api::currentDriver().valueSelectorSetTransferFunction(
+      valueSelector,
+      reinterpret_cast<const range1f &>(*valueRange),
+      utility::ArrayView<const float>(opacities, numOpacities));
+}
+OPENVKL_CATCH_END()
+
+extern "C" void vklValueSelectorSetClipBoxes(VKLValueSelector valueSelector,
+                                             size_t numBoxes,
+                                             const vkl_box3f *boxes)
+    OPENVKL_CATCH_BEGIN
+{
+  ASSERT_DRIVER();
+  openvkl::api::currentDriver().valueSelectorSetClipBoxes(
+      valueSelector,
+      utility::ArrayView<const box3f>(reinterpret_cast<const box3f *>(boxes),
+                                      numBoxes));
+}
+OPENVKL_CATCH_END()
+
+extern "C" void vklValueSelectorSetClipPlanes(VKLValueSelector valueSelector,
+                                              size_t numPlanes,
+                                              const float *planes)
+    OPENVKL_CATCH_BEGIN
+{
+  ASSERT_DRIVER();
+  openvkl::api::currentDriver().valueSelectorSetClipPlanes(
+      valueSelector,
+      utility::ArrayView<const vec4f>(reinterpret_cast<const vec4f *>(planes),
+                                      numPlanes));
+}
+OPENVKL_CATCH_END()
+
 ///////////////////////////////////////////////////////////////////////////////
 // Volume /////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -656,6 +859,113 @@ __define_vklComputeSampleN(16);
 
 #undef __define_vklComputeSampleN
 
+extern "C" float vklComputeSampleTime(VKLVolume volume,
+                                      const vkl_vec3f *objectCoordinates,
+                                      float time) OPENVKL_CATCH_BEGIN
+{
+  constexpr int valid = 1;
+  float sample;
+  openvkl::api::currentDriver().computeSampleTime1(
+      &valid,
+      volume,
+      reinterpret_cast<const vvec3fn<1> &>(*objectCoordinates),
+      &time,
+      &sample);
+  return sample;
+}
+OPENVKL_CATCH_END(ospcommon::math::nan)
+
+#define __define_vklComputeSampleTimeN(WIDTH)                         \
+  extern "C" void vklComputeSampleTime##WIDTH(                        \
+      const int *valid,                                               \
+      VKLVolume volume,                                               \
+      const vkl_vvec3f##WIDTH *objectCoordinates,                     \
+      const float *times,                                             \
+      float *samples) OPENVKL_CATCH_BEGIN                             \
+  {                                                                   \
+    openvkl::api::currentDriver().computeSampleTime##WIDTH(           \
+        valid,                                                        \
+        volume,                                                       \
+        reinterpret_cast<const vvec3fn<WIDTH> &>(*objectCoordinates), \
+        times,                                                        \
+        samples);                                                     \
+  }                                                                   \
+  OPENVKL_CATCH_END()
+
+__define_vklComputeSampleTimeN(4);
+__define_vklComputeSampleTimeN(8);
+__define_vklComputeSampleTimeN(16);
+
+#undef __define_vklComputeSampleTimeN
+
+extern "C" float vklComputeSampleLod(VKLVolume volume,
+                                     const vkl_vec3f *objectCoordinates,
+                                     float lod) OPENVKL_CATCH_BEGIN
+{
+  constexpr int valid = 1;
+  float sample;
+  openvkl::api::currentDriver().computeSampleLod1(
+      &valid,
+      volume,
+      reinterpret_cast<const vvec3fn<1> &>(*objectCoordinates),
+      &lod,
+      &sample);
+  return sample;
+}
+OPENVKL_CATCH_END(ospcommon::math::nan)
+
+#define __define_vklComputeSampleLodN(WIDTH)                          \
+  extern "C" void vklComputeSampleLod##WIDTH(                         \
+      const int *valid,                                               \
+      VKLVolume volume,                                               \
+      const vkl_vvec3f##WIDTH *objectCoordinates,                     \
+      const float *lods,                                              \
+      float *samples) OPENVKL_CATCH_BEGIN                             \
+  {                                                                   \
+    openvkl::api::currentDriver().computeSampleLod##WIDTH(            \
+        valid,                                                        \
+        volume,                                                       \
+        reinterpret_cast<const vvec3fn<WIDTH> &>(*objectCoordinates), \
+        lods,                                                         \
+        samples);                                                     \
+  }                                                                   \
+  OPENVKL_CATCH_END()
+
+__define_vklComputeSampleLodN(4);
+__define_vklComputeSampleLodN(8);
+__define_vklComputeSampleLodN(16);
+
+#undef __define_vklComputeSampleLodN
+
+extern "C" void vklSampleRay(VKLVolume volume,
+                             const vkl_vec3f *origin,
+                             const vkl_vec3f *direction,
+                             float t0,
+                             float dt,
+                             unsigned int numSamples,
+                             float *samples) OPENVKL_CATCH_BEGIN
+{
+  THROW_IF_NULL_OBJECT(volume);
+  THROW_IF_NULL(origin, "origin");
+  THROW_IF_NULL(direction, "direction");
+
+  if (numSamples == 0) {
+    return;
+  }
+
+  THROW_IF_NULL(samples, "samples");
+
+  openvkl::api::currentDriver().sampleRay(
+      volume,
+      reinterpret_cast<const vvec3fn<1> &>(*origin),
+      reinterpret_cast<const vvec3fn<1> &>(*direction),
+      t0,
+      dt,
+      numSamples,
+      samples);
+}
+OPENVKL_CATCH_END()
+
 extern "C" vkl_vec3f vklComputeGradient(
     VKLVolume volume, const vkl_vec3f *objectCoordinates) OPENVKL_CATCH_BEGIN
 {
@@ -698,6 +1008,15 @@ extern "C" vkl_box3f vklGetBoundingBox(VKLVolume volume) OPENVKL_CATCH_BEGIN
 }
 OPENVKL_CATCH_END(vkl_box3f{ospcommon::math::nan})
 
+extern "C" vkl_box3f vklGetActiveBoundingBox(VKLVolume volume)
+    OPENVKL_CATCH_BEGIN
+{
+  const box3f result =
+      openvkl::api::currentDriver().getActiveBoundingBox(volume);
+  return reinterpret_cast<const vkl_box3f &>(result);
+}
+OPENVKL_CATCH_END(vkl_box3f{ospcommon::math::nan})
+
 extern "C" vkl_range1f vklGetValueRange(VKLVolume volume) OPENVKL_CATCH_BEGIN
 {
   const range1f result = openvkl::api::currentDriver().getValueRange(volume);
@@ -145,7 +145,7 @@ namespace openvkl {
 
       // threads
       auto OPENVKL_THREADS = utility::getEnvVar<int>("OPENVKL_THREADS");
-      int numThreads =
+      numThreads =
           OPENVKL_THREADS.value_or(getParam<int>("numThreads", -1));
 
       // flush to zero / denormals are zero
@@ -57,6 +57,10 @@ namespace openvkl {
       std::function<void(VKLError, const char *)> errorFunction{
           [](VKLError, const char *) {}};
 
+      // number of threads requested for the tasking system; -1 means all
+      // available hardware threads
+      int numThreads{-1};
+
       /////////////////////////////////////////////////////////////////////////
       // Data /////////////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
@@ -80,6 +84,12 @@ namespace openvkl {
       // Interval iterator ////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
 
+      virtual size_t getIntervalIteratorSize(VKLVolume volume, int width)
+      {
+        throw std::runtime_error(
+            "getIntervalIteratorSize() not implemented on this driver");
+      }
+
       virtual void initIntervalIterator1(vVKLIntervalIteratorN<1> &iterator,
                                          VKLVolume volume,
                                          const vvec3fn<1> &origin,
@@ -135,10 +145,51 @@ namespace openvkl {
 
 #undef __define_iterateIntervalN
 
+      virtual void getIntervalIteratorCheckpoint1(
+          const vVKLIntervalIteratorN<1> &iterator,
+          VKLIntervalIteratorCheckpoint &checkpoint)
+      {
+        throw std::runtime_error(
+            "getIntervalIteratorCheckpoint1() not implemented on this driver");
+      }
+
+      virtual void resumeIntervalIterator1(
+          vVKLIntervalIteratorN<1> &iterator,
+          VKLVolume volume,
+          const vvec3fn<1> &origin,
+          const vvec3fn<1> &direction,
+          const vrange1fn<1> &tRange,
+          const VKLIntervalIteratorCheckpoint &checkpoint,
+          VKLValueSelector valueSelector)
+      {
+        throw std::runtime_error(
+            "resumeIntervalIterator1() not implemented on this driver");
+      }
+
+      virtual void iterateIntervalStream(VKLVolume volume,
+                                         size_t numRays,
+                                         const vkl_vec3f *origins,
+                                         const vkl_vec3f *directions,
+                                         const vkl_range1f *tRanges,
+                                         VKLValueSelector valueSelector,
+                                         size_t maxIntervalsPerRay,
+                                         VKLInterval *intervals,
+                                         uint32_t *numIntervals)
+      {
+        throw std::runtime_error(
+            "iterateIntervalStream() not implemented on this driver");
+      }
+
       /////////////////////////////////////////////////////////////////////////
       // Hit iterator /////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
 
+      virtual size_t getHitIteratorSize(VKLVolume volume, int width)
+      {
+        throw std::runtime_error(
+            "getHitIteratorSize() not implemented on this driver");
+      }
+
       virtual void initHitIterator1(vVKLHitIteratorN<1> &iterator,
                                     VKLVolume volume,
                                     const vvec3fn<1> &origin,
@@ -169,6 +220,38 @@ namespace openvkl {
 
 #undef __define_initHitIteratorN
 
+      virtual void initHitIteratorTime1(vVKLHitIteratorN<1> &iterator,
+                                        VKLVolume volume,
+                                        const vvec3fn<1> &origin,
+                                        const vvec3fn<1> &direction,
+                                        const vrange1fn<1> &tRange,
+                                        const float *time,
+                                        VKLValueSelector valueSelector)
+      {
+        throw std::runtime_error(
+            "initHitIteratorTime1() not implemented on this driver");
+      }
+
+#define __define_initHitIteratorTimeN(WIDTH)                                 \
+  virtual void initHitIteratorTime##WIDTH(const int *valid,                  \
+                                          vVKLHitIteratorN<WIDTH> &iterator, \
+                                          VKLVolume volume,                  \
+                                          const vvec3fn<WIDTH> &origin,      \
+                                          const vvec3fn<WIDTH> &direction,   \
+                                          const vrange1fn<WIDTH> &tRange,    \
+                                          const float *times,                \
+                                          VKLValueSelector valueSelector)    \
+  {                                                                          \
+    throw std::runtime_error(                                                \
+        "initHitIteratorTime##WIDTH() not implemented on this driver");      \
+  }
+
+      __define_initHitIteratorTimeN(4);
+      __define_initHitIteratorTimeN(8);
+      __define_initHitIteratorTimeN(16);
+
+#undef __define_initHitIteratorTimeN
+
       virtual void iterateHit1(vVKLHitIteratorN<1> &iterator,
                                vVKLHitN<1> &hit,
                                int *result)
@@ -236,6 +319,19 @@ namespace openvkl {
           VKLValueSelector valueSelector,
           const utility::ArrayView<const float> &values) = 0;
 
+      virtual void valueSelectorSetTransferFunction(
+          VKLValueSelector valueSelector,
+          const range1f &valueRange,
+          const utility::ArrayView<const float> &opacities) = 0;
+
+      virtual void valueSelectorSetClipBoxes(
+          VKLValueSelector valueSelector,
+          const utility::ArrayView<const box3f> &boxes) = 0;
+
+      virtual void valueSelectorSetClipPlanes(
+          VKLValueSelector valueSelector,
+          const utility::ArrayView<const vec4f> &planes) = 0;
+
       /////////////////////////////////////////////////////////////////////////
       // Volume ///////////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
@@ -255,6 +351,55 @@ namespace openvkl {
 
 #undef __define_computeSampleN
 
+#define __define_computeSampleTimeN(WIDTH)                                   \
+  virtual void computeSampleTime##WIDTH(                                     \
+      const int *valid,                                                      \
+      VKLVolume volume,                                                      \
+      const vvec3fn<WIDTH> &objectCoordinates,                               \
+      const float *times,                                                    \
+      float *samples)                                                        \
+  {                                                                          \
+    throw std::runtime_error(                                                \
+        "computeSampleTime##WIDTH() not implemented on this driver");        \
+  }
+
+      __define_computeSampleTimeN(1);
+      __define_computeSampleTimeN(4);
+      __define_computeSampleTimeN(8);
+      __define_computeSampleTimeN(16);
+
+#undef __define_computeSampleTimeN
+
+#define __define_computeSampleLodN(WIDTH)                                    \
+  virtual void computeSampleLod##WIDTH(                                      \
+      const int *valid,                                                      \
+      VKLVolume volume,                                                      \
+      const vvec3fn<WIDTH> &objectCoordinates,                               \
+      const float *lods,                                                     \
+      float *samples)                                                        \
+  {                                                                          \
+    throw std::runtime_error(                                                \
+        "computeSampleLod##WIDTH() not implemented on this driver");         \
+  }
+
+      __define_computeSampleLodN(1);
+      __define_computeSampleLodN(4);
+      __define_computeSampleLodN(8);
+      __define_computeSampleLodN(16);
+
+#undef __define_computeSampleLodN
+
+      virtual void sampleRay(VKLVolume volume,
+                             const vvec3fn<1> &origin,
+                             const vvec3fn<1> &direction,
+                             float t0,
+                             float dt,
+                             unsigned int numSamples,
+                             float *samples)
+      {
+        throw std::runtime_error("sampleRay() not implemented on this driver");
+      }
+
 #define __define_computeGradientN(WIDTH)                                       \
   virtual void computeGradient##WIDTH(const int *valid,                        \
                                       VKLVolume volume,                        \
@@ -270,6 +415,8 @@ namespace openvkl {
 
       virtual box3f getBoundingBox(VKLVolume volume) = 0;
 
+      virtual box3f getActiveBoundingBox(VKLVolume volume) = 0;
+
       virtual range1f getValueRange(VKLVolume volume) = 0;
 
      private:
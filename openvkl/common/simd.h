@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include "openvkl/openvkl.h"
 #include "ospcommon/platform.h"
 
@@ -202,9 +203,11 @@ namespace openvkl {
   struct alignas(simd_alignment_for_width_promote_scalar(W))
       vVKLIntervalIteratorN
   {
+    // The volume comes first, so that iterators may be allocated with only as
+    // much internal state as they need.
+    VKLVolume volume;
     alignas(simd_alignment_for_width_promote_scalar(
         W)) char internalState[iterator_internal_state_size_for_width(W)];
-    VKLVolume volume;
 
     vVKLIntervalIteratorN<W>() = default;
 
@@ -235,7 +238,13 @@ namespace openvkl {
                         iterator_internal_state_size_for_width(W),
                     "vVKLIntervalIteratorN<W2> is larger than source type");
 
-      return reinterpret_cast<vVKLIntervalIteratorN<W2> *>(this);
+      // The internal state of the result aliases ours, while its volume
+      // member lies in our padding.
+      const size_t offset = offsetof(vVKLIntervalIteratorN<W>, internalState) -
+                            offsetof(vVKLIntervalIteratorN<W2>, internalState);
+
+      return reinterpret_cast<vVKLIntervalIteratorN<W2> *>(
+          reinterpret_cast<char *>(this) + offset);
     }
   };
 
@@ -245,13 +254,15 @@ namespace openvkl {
     vrange1fn<W> tRange;
     vrange1fn<W> valueRange;
     vfloatn<W> nominalDeltaT;
+    vfloatn<W> majorant;
 
     vVKLIntervalN<W>() = default;
 
     vVKLIntervalN<W>(const vVKLIntervalN<W> &v)
         : tRange(v.tRange),
           valueRange(v.valueRange),
-          nominalDeltaT(v.nominalDeltaT)
+          nominalDeltaT(v.nominalDeltaT),
+          majorant(v.majorant)
     {
     }
 
@@ -263,6 +274,7 @@ namespace openvkl {
       interval.valueRange.lower = valueRange.lower[0];
       interval.valueRange.upper = valueRange.upper[0];
       interval.nominalDeltaT    = nominalDeltaT[0];
+      interval.majorant         = majorant[0];
     }
 
     template <int W2 = W, typename = std::enable_if<(W == 4)>>
@@ -275,6 +287,7 @@ namespace openvkl {
           interval.valueRange.lower[i] = valueRange.lower[i];
           interval.valueRange.upper[i] = valueRange.upper[i];
           interval.nominalDeltaT[i]    = nominalDeltaT[i];
+          interval.majorant[i]         = majorant[i];
         }
       }
     }
@@ -289,6 +302,7 @@ namespace openvkl {
           interval.valueRange.lower[i] = valueRange.lower[i];
           interval.valueRange.upper[i] = valueRange.upper[i];
           interval.nominalDeltaT[i]    = nominalDeltaT[i];
+          interval.majorant[i]         = majorant[i];
         }
       }
     }
@@ -303,6 +317,7 @@ namespace openvkl {
           interval.valueRange.lower[i] = valueRange.lower[i];
           interval.valueRange.upper[i] = valueRange.upper[i];
           interval.nominalDeltaT[i]    = nominalDeltaT[i];
+          interval.majorant[i]         = majorant[i];
         }
       }
     }
@@ -311,9 +326,11 @@ namespace openvkl {
   template <int W>
   struct alignas(simd_alignment_for_width_promote_scalar(W)) vVKLHitIteratorN
   {
+    // The volume comes first, so that iterators may be allocated with only as
+    // much internal state as they need.
+    VKLVolume volume;
     alignas(simd_alignment_for_width_promote_scalar(
         W)) char internalState[iterator_internal_state_size_for_width(W)];
-    VKLVolume volume;
 
     vVKLHitIteratorN<W>() = default;
 
@@ -343,7 +360,13 @@ namespace openvkl {
                         iterator_internal_state_size_for_width(W),
                     "vVKLHitIteratorN<W2> is larger than source type");
 
-      return reinterpret_cast<vVKLHitIteratorN<W2> *>(this);
+      // The internal state of the result aliases ours, while its volume
+      // member lies in our padding.
+      const size_t offset = offsetof(vVKLHitIteratorN<W>, internalState) -
+                            offsetof(vVKLHitIteratorN<W2>, internalState);
+
+      return reinterpret_cast<vVKLHitIteratorN<W2> *>(
+          reinterpret_cast<char *>(this) + offset);
     }
   };
 
@@ -8,10 +8,96 @@
 #include "../value_selector/ValueSelector.h"
 #include "../volume/Volume.h"
 #include "ISPCDriver_ispc.h"
+#include "ospcommon/tasking/parallel_for.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
 
 namespace openvkl {
   namespace ispc_driver {
 
+    static void embreeErrorFunction(void *userPtr,
+                                    enum RTCError error,
+                                    const char *str)
+    {
+      LogMessageStream(VKL_LOG_WARNING)
+          << "embree error " << error << ": " << str << std::endl;
+    }
+
+    // Size of an iterator whose internal state occupies stateSize bytes,
+    // rounded up so that consecutive iterators stay aligned.
+    template <typename IteratorT>
+    static size_t iteratorSize(size_t stateSize)
+    {
+      const size_t size  = offsetof(IteratorT, internalState) + stateSize;
+      const size_t align = alignof(IteratorT);
+      return std::min(sizeof(IteratorT), (size + align - 1) / align * align);
+    }
+
+    // Spreads the lower 10 bits of x to every third bit.
+    static uint64_t spreadBits(uint64_t x)
+    {
+      x = (x | (x << 16)) & 0x030000FF;
+      x = (x | (x << 8)) & 0x0300F00F;
+      x = (x | (x << 4)) & 0x030C30C3;
+      x = (x | (x << 2)) & 0x09249249;
+      return x;
+    }
+
+    // Sort key for a ray: the direction octant, followed by the Morton code
+    // of the point where the ray enters the bounding box. Rays with close
+    // keys traverse the same cells in the same order. Rays that miss the box
+    // sort last.
+    static uint64_t rayEntryKey(const box3f &bounds,
+                                const vkl_vec3f &origin,
+                                const vkl_vec3f &direction,
+                                const vkl_range1f &tRange)
+    {
+      const float org[3] = {origin.x, origin.y, origin.z};
+      const float dir[3] = {direction.x, direction.y, direction.z};
+      const float lo[3]  = {bounds.lower.x, bounds.lower.y, bounds.lower.z};
+      const float hi[3]  = {bounds.upper.x, bounds.upper.y, bounds.upper.z};
+
+      // NaNs from rays parallel to a slab leave t0 and t1 unchanged.
+      float t0 = tRange.lower;
+      float t1 = tRange.upper;
+      for (int a = 0; a < 3; a++) {
+        const float rcpDir = 1.f / dir[a];
+        float tNear        = (lo[a] - org[a]) * rcpDir;
+        float tFar         = (hi[a] - org[a]) * rcpDir;
+        if (tNear > tFar)
+          std::swap(tNear, tFar);
+        t0 = std::max(t0, tNear);
+        t1 = std::min(t1, tFar);
+      }
+
+      if (!(t0 <= t1))
+        return std::numeric_limits<uint64_t>::max();
+
+      constexpr uint32_t res = 1024;
+
+      uint64_t key = 0;
+      for (int a = 0; a < 3; a++) {
+        const float extent = std::max(hi[a] - lo[a], 1e-20f);
+        const float c      = (org[a] + t0 * dir[a] - lo[a]) / extent * res;
+        const uint64_t cell =
+            !(c > 0.f) ? 0 : (c >= res ? res - 1 : uint64_t(c));
+        key |= spreadBits(cell) << a;
+      }
+
+      const uint64_t octant =
+          (dir[0] < 0.f) | (dir[1] < 0.f) << 1 | (dir[2] < 0.f) << 2;
+
+      return octant << 30 | key;
+    }
+
+    template <int W>
+    ISPCDriver<W>::~ISPCDriver()
+    {
+      releaseEmbreeDevice();
+    }
+
     template <int W>
     bool ISPCDriver<W>::supportsWidth(int width)
     {
@@ -28,6 +114,12 @@ namespace openvkl {
     void ISPCDriver<W>::commit()
     {
       Driver::commit();
+
+      // the Embree device is recreated lazily if the thread count changed;
+      // BVHs built on a previous device retain it until they are released
+      if (embreeDevice && embreeDeviceNumThreads != this->numThreads) {
+        releaseEmbreeDevice();
+      }
     }
 
     template <int W>
@@ -101,6 +193,24 @@ namespace openvkl {
     // Interval iterator //////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
+    template <int W>
+    size_t ISPCDriver<W>::getIntervalIteratorSize(VKLVolume volume, int width)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+
+      if (width == 1) {
+        return iteratorSize<vVKLIntervalIteratorN<1>>(
+            volumeObject.getIntervalIteratorSizeU());
+      } else if (width == W) {
+        return iteratorSize<vVKLIntervalIteratorN<W>>(
+            volumeObject.getIntervalIteratorSizeV());
+      }
+
+      throw std::runtime_error(
+          "interval iterator sizes can only be queried for the scalar or "
+          "native runtime vector width");
+    }
+
     template <int W>
     void ISPCDriver<W>::initIntervalIterator1(
         vVKLIntervalIteratorN<1> &iterator,
@@ -171,10 +281,175 @@ namespace openvkl {
 
 #undef __define_iterateIntervalN
 
+    template <int W>
+    void ISPCDriver<W>::getIntervalIteratorCheckpoint1(
+        const vVKLIntervalIteratorN<1> &iterator,
+        VKLIntervalIteratorCheckpoint &checkpoint)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(iterator.volume);
+
+      volumeObject.getIntervalIteratorCheckpointU(iterator, checkpoint);
+    }
+
+    template <int W>
+    void ISPCDriver<W>::resumeIntervalIterator1(
+        vVKLIntervalIteratorN<1> &iterator,
+        VKLVolume volume,
+        const vvec3fn<1> &origin,
+        const vvec3fn<1> &direction,
+        const vrange1fn<1> &tRange,
+        const VKLIntervalIteratorCheckpoint &checkpoint,
+        VKLValueSelector valueSelector)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+
+      iterator.volume = (VKLVolume)&volumeObject;
+
+      volumeObject.resumeIntervalIteratorU(
+          iterator,
+          origin,
+          direction,
+          tRange,
+          checkpoint,
+          reinterpret_cast<const ValueSelector<W> *>(valueSelector));
+    }
+
+    template <int W>
+    void ISPCDriver<W>::iterateIntervalStream(VKLVolume volume,
+                                              size_t numRays,
+                                              const vkl_vec3f *origins,
+                                              const vkl_vec3f *directions,
+                                              const vkl_range1f *tRanges,
+                                              VKLValueSelector valueSelector,
+                                              size_t maxIntervalsPerRay,
+                                              VKLInterval *intervals,
+                                              uint32_t *numIntervals)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+      const auto *selector =
+          reinterpret_cast<const ValueSelector<W> *>(valueSelector);
+
+      const vkl_range1f fullRange{0.f, std::numeric_limits<float>::infinity()};
+
+      // Rays are traversed in packets of the native width, in the order in
+      // which they enter the volume, so that the lanes of a packet (and the
+      // packets of a task) touch the same cells.
+      const box3f bounds = volumeObject.getBoundingBox();
+      std::vector<std::pair<uint64_t, size_t>> order(numRays);
+      tasking::parallel_for(numRays, [&](size_t i) {
+        order[i] = std::make_pair(
+            rayEntryKey(bounds,
+                        origins[i],
+                        directions[i],
+                        tRanges ? tRanges[i] : fullRange),
+            i);
+      });
+      std::sort(order.begin(), order.end());
+
+      constexpr size_t packetsPerTask = 16;
+      const size_t numPackets         = (numRays + W - 1) / W;
+      const size_t numTasks =
+          (numPackets + packetsPerTask - 1) / packetsPerTask;
+
+      tasking::parallel_for(numTasks, [&](size_t taskIndex) {
+        const size_t packetEnd =
+            std::min(numPackets, (taskIndex + 1) * packetsPerTask);
+
+        for (size_t p = taskIndex * packetsPerTask; p < packetEnd; p++) {
+          vintn<W> valid;
+          size_t rays[W];
+          vvec3fn<W> origin;
+          vvec3fn<W> direction;
+          vrange1fn<W> tRange;
+
+          // Inactive lanes replicate the first ray of the packet.
+          for (int i = 0; i < W; i++) {
+            const size_t r = p * W + i;
+            valid[i]       = r < numRays ? -1 : 0;
+            rays[i]        = order[valid[i] ? r : p * W].second;
+
+            const vkl_vec3f &o   = origins[rays[i]];
+            const vkl_vec3f &d   = directions[rays[i]];
+            const vkl_range1f &t = tRanges ? tRanges[rays[i]] : fullRange;
+            origin.x[i]          = o.x;
+            origin.y[i]          = o.y;
+            origin.z[i]          = o.z;
+            direction.x[i]       = d.x;
+            direction.y[i]       = d.y;
+            direction.z[i]       = d.z;
+            tRange.lower[i]      = t.lower;
+            tRange.upper[i]      = t.upper;
+
+            if (valid[i])
+              numIntervals[rays[i]] = 0;
+          }
+
+          vVKLIntervalIteratorN<W> iterator;
+          iterator.volume = (VKLVolume)&volumeObject;
+          volumeObject.initIntervalIteratorV(
+              valid, iterator, origin, direction, tRange, selector);
+
+          vVKLIntervalN<W> interval;
+          vintn<W> result;
+
+          for (;;) {
+            bool anyValid = false;
+            for (int i = 0; i < W; i++)
+              anyValid |= (valid[i] != 0);
+            if (!anyValid)
+              break;
+
+            volumeObject.iterateIntervalV(valid, iterator, interval, result);
+
+            for (int i = 0; i < W; i++) {
+              if (!valid[i])
+                continue;
+
+              if (!result[i]) {
+                valid[i] = 0;
+                continue;
+              }
+
+              uint32_t &n = numIntervals[rays[i]];
+              VKLInterval &out =
+                  intervals[rays[i] * maxIntervalsPerRay + n];
+              out.tRange.lower     = interval.tRange.lower[i];
+              out.tRange.upper     = interval.tRange.upper[i];
+              out.valueRange.lower = interval.valueRange.lower[i];
+              out.valueRange.upper = interval.valueRange.upper[i];
+              out.nominalDeltaT    = interval.nominalDeltaT[i];
+              out.majorant         = interval.majorant[i];
+
+              if (++n == maxIntervalsPerRay)
+                valid[i] = 0;
+            }
+          }
+        }
+      });
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Hit iterator ///////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
+    template <int W>
+    size_t ISPCDriver<W>::getHitIteratorSize(VKLVolume volume, int width)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+
+      if (width == 1) {
+        return iteratorSize<vVKLHitIteratorN<1>>(
+            volumeObject.getHitIteratorSizeU());
+      } else if (width == W) {
+        return iteratorSize<vVKLHitIteratorN<W>>(
+            volumeObject.getHitIteratorSizeV());
+      }
+
+      throw std::runtime_error(
+          "hit iterator sizes can only be queried for the scalar or "
+          "native runtime vector width");
+    }
+
     template <int W>
     void ISPCDriver<W>::initHitIterator1(vVKLHitIteratorN<1> &iterator,
                                          VKLVolume volume,
@@ -206,8 +481,14 @@ namespace openvkl {
       const vrange1fn<WIDTH> &tRange,                                       \
       VKLValueSelector valueSelector)                                       \
   {                                                                         \
-    initHitIteratorAnyWidth<WIDTH>(                                         \
-        valid, iterator, volume, origin, direction, tRange, valueSelector); \
+    initHitIteratorAnyWidth<WIDTH>(valid,                                   \
+                                   iterator,                                \
+                                   volume,                                  \
+                                   origin,                                  \
+                                   direction,                               \
+                                   tRange,                                  \
+                                   nullptr,                                 \
+                                   valueSelector);                          \
   }
 
     __define_initHitIteratorN(4);
@@ -216,6 +497,56 @@ namespace openvkl {
 
 #undef __define_initHitIteratorN
 
+    template <int W>
+    void ISPCDriver<W>::initHitIteratorTime1(vVKLHitIteratorN<1> &iterator,
+                                             VKLVolume volume,
+                                             const vvec3fn<1> &origin,
+                                             const vvec3fn<1> &direction,
+                                             const vrange1fn<1> &tRange,
+                                             const float *time,
+                                             VKLValueSelector valueSelector)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+
+      iterator.volume = (VKLVolume)&volumeObject;
+
+      volumeObject.initHitIteratorTimeU(
+          iterator,
+          origin,
+          direction,
+          tRange,
+          *time,
+          reinterpret_cast<const ValueSelector<W> *>(valueSelector));
+    }
+
+#define __define_initHitIteratorTimeN(WIDTH)                                \
+  template <int W>                                                          \
+  void ISPCDriver<W>::initHitIteratorTime##WIDTH(                           \
+      const int *valid,                                                     \
+      vVKLHitIteratorN<WIDTH> &iterator,                                    \
+      VKLVolume volume,                                                     \
+      const vvec3fn<WIDTH> &origin,                                         \
+      const vvec3fn<WIDTH> &direction,                                      \
+      const vrange1fn<WIDTH> &tRange,                                       \
+      const float *times,                                                   \
+      VKLValueSelector valueSelector)                                       \
+  {                                                                         \
+    initHitIteratorAnyWidth<WIDTH>(valid,                                   \
+                                   iterator,                                \
+                                   volume,                                  \
+                                   origin,                                  \
+                                   direction,                               \
+                                   tRange,                                  \
+                                   times,                                   \
+                                   valueSelector);                          \
+  }
+
+    __define_initHitIteratorTimeN(4);
+    __define_initHitIteratorTimeN(8);
+    __define_initHitIteratorTimeN(16);
+
+#undef __define_initHitIteratorTimeN
+
     template <int W>
     void ISPCDriver<W>::iterateHit1(vVKLHitIteratorN<1> &iterator,
                                     vVKLHitN<1> &hit,
@@ -355,6 +686,37 @@ namespace openvkl {
       valueSelectorObject.setValues(values);
     }
 
+    template <int W>
+    void ISPCDriver<W>::valueSelectorSetTransferFunction(
+        VKLValueSelector valueSelector,
+        const range1f &valueRange,
+        const utility::ArrayView<const float> &opacities)
+    {
+      auto &valueSelectorObject =
+          referenceFromHandle<ValueSelector<W>>(valueSelector);
+      valueSelectorObject.setTransferFunction(valueRange, opacities);
+    }
+
+    template <int W>
+    void ISPCDriver<W>::valueSelectorSetClipBoxes(
+        VKLValueSelector valueSelector,
+        const utility::ArrayView<const box3f> &boxes)
+    {
+      auto &valueSelectorObject =
+          referenceFromHandle<ValueSelector<W>>(valueSelector);
+      valueSelectorObject.setClipBoxes(boxes);
+    }
+
+    template <int W>
+    void ISPCDriver<W>::valueSelectorSetClipPlanes(
+        VKLValueSelector valueSelector,
+        const utility::ArrayView<const vec4f> &planes)
+    {
+      auto &valueSelectorObject =
+          referenceFromHandle<ValueSelector<W>>(valueSelector);
+      valueSelectorObject.setClipPlanes(planes);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Volume /////////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -385,7 +747,8 @@ namespace openvkl {
       const vvec3fn<WIDTH> &objectCoordinates,                               \
       float *samples)                                                        \
   {                                                                          \
-    computeSampleAnyWidth<WIDTH>(valid, volume, objectCoordinates, samples); \
+    computeSampleAnyWidth<WIDTH>(                                            \
+        valid, volume, objectCoordinates, nullptr, nullptr, samples);        \
   }
 
     __define_computeSampleN(4);
@@ -407,6 +770,85 @@ namespace openvkl {
       *sample = sampleW[0];
     }
 
+#define __define_computeSampleTimeN(WIDTH)                 \
+  template <int W>                                         \
+  void ISPCDriver<W>::computeSampleTime##WIDTH(            \
+      const int *valid,                                    \
+      VKLVolume volume,                                    \
+      const vvec3fn<WIDTH> &objectCoordinates,             \
+      const float *times,                                  \
+      float *samples)                                      \
+  {                                                        \
+    computeSampleAnyWidth<WIDTH>(                          \
+        valid, volume, objectCoordinates, times, nullptr,  \
+        samples);                                          \
+  }
+
+    __define_computeSampleTimeN(4);
+    __define_computeSampleTimeN(8);
+    __define_computeSampleTimeN(16);
+
+#undef __define_computeSampleTimeN
+
+    template <int W>
+    void ISPCDriver<W>::computeSampleTime1(const int *valid,
+                                           VKLVolume volume,
+                                           const vvec3fn<1> &objectCoordinates,
+                                           const float *time,
+                                           float *sample)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+      vfloatn<1> sampleW;
+      volumeObject.computeSampleTime(objectCoordinates, *time, sampleW);
+      *sample = sampleW[0];
+    }
+
+#define __define_computeSampleLodN(WIDTH)                                  \
+  template <int W>                                                         \
+  void ISPCDriver<W>::computeSampleLod##WIDTH(                             \
+      const int *valid,                                                    \
+      VKLVolume volume,                                                    \
+      const vvec3fn<WIDTH> &objectCoordinates,                             \
+      const float *lods,                                                   \
+      float *samples)                                                      \
+  {                                                                        \
+    computeSampleAnyWidth<WIDTH>(                                          \
+        valid, volume, objectCoordinates, nullptr, lods, samples);         \
+  }
+
+    __define_computeSampleLodN(4);
+    __define_computeSampleLodN(8);
+    __define_computeSampleLodN(16);
+
+#undef __define_computeSampleLodN
+
+    template <int W>
+    void ISPCDriver<W>::computeSampleLod1(const int *valid,
+                                          VKLVolume volume,
+                                          const vvec3fn<1> &objectCoordinates,
+                                          const float *lod,
+                                          float *sample)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+      vfloatn<1> sampleW;
+      volumeObject.computeSampleLod(objectCoordinates, *lod, sampleW);
+      *sample = sampleW[0];
+    }
+
+    template <int W>
+    void ISPCDriver<W>::sampleRay(VKLVolume volume,
+                                  const vvec3fn<1> &origin,
+                                  const vvec3fn<1> &direction,
+                                  float t0,
+                                  float dt,
+                                  unsigned int numSamples,
+                                  float *samples)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+      volumeObject.computeSampleRay(
+          origin, direction, t0, dt, numSamples, samples);
+    }
+
 #define __define_computeGradientN(WIDTH)              \
   template <int W>                                    \
   void ISPCDriver<W>::computeGradient##WIDTH(         \
@@ -433,6 +875,13 @@ namespace openvkl {
       return volumeObject.getBoundingBox();
     }
 
+    template <int W>
+    box3f ISPCDriver<W>::getActiveBoundingBox(VKLVolume volume)
+    {
+      auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
+      return volumeObject.getActiveBoundingBox();
+    }
+
     template <int W>
     range1f ISPCDriver<W>::getValueRange(VKLVolume volume)
     {
@@ -440,10 +889,51 @@ namespace openvkl {
       return volumeObject.getValueRange();
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    // Embree device //////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    template <int W>
+    RTCDevice ISPCDriver<W>::getEmbreeDevice()
+    {
+      std::lock_guard<std::mutex> lock(embreeDeviceMutex);
+
+      if (!embreeDevice) {
+        // a non-positive thread count lets Embree use all hardware threads
+        std::string config;
+        if (this->numThreads > 0) {
+          config = "threads=" + std::to_string(this->numThreads);
+        }
+
+        embreeDevice = rtcNewDevice(config.empty() ? nullptr : config.c_str());
+
+        if (!embreeDevice) {
+          throw std::runtime_error("cannot create Embree device");
+        }
+
+        rtcSetDeviceErrorFunction(embreeDevice, embreeErrorFunction, nullptr);
+
+        embreeDeviceNumThreads = this->numThreads;
+      }
+
+      return embreeDevice;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Private methods ////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
+    template <int W>
+    void ISPCDriver<W>::releaseEmbreeDevice()
+    {
+      std::lock_guard<std::mutex> lock(embreeDeviceMutex);
+
+      if (embreeDevice) {
+        rtcReleaseDevice(embreeDevice);
+        embreeDevice = nullptr;
+      }
+    }
+
     template <int W>
     template <int OW>
     typename std::enable_if<(OW == W), void>::type
@@ -534,6 +1024,7 @@ namespace openvkl {
                                            const vvec3fn<OW> &origin,
                                            const vvec3fn<OW> &direction,
                                            const vrange1fn<OW> &tRange,
+                                           const float *times,
                                            VKLValueSelector valueSelector)
     {
       auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
@@ -544,13 +1035,28 @@ namespace openvkl {
       for (int i = 0; i < W; i++)
         validW[i] = valid[i];
 
-      volumeObject.initHitIteratorV(
-          validW,
-          iterator,
-          origin,
-          direction,
-          tRange,
-          reinterpret_cast<const ValueSelector<W> *>(valueSelector));
+      if (times) {
+        vfloatn<W> timesW;
+        for (int i = 0; i < W; i++)
+          timesW[i] = times[i];
+
+        volumeObject.initHitIteratorTimeV(
+            validW,
+            iterator,
+            origin,
+            direction,
+            tRange,
+            timesW,
+            reinterpret_cast<const ValueSelector<W> *>(valueSelector));
+      } else {
+        volumeObject.initHitIteratorV(
+            validW,
+            iterator,
+            origin,
+            direction,
+            tRange,
+            reinterpret_cast<const ValueSelector<W> *>(valueSelector));
+      }
     }
 
     template <int W>
@@ -562,6 +1068,7 @@ namespace openvkl {
                                            const vvec3fn<OW> &origin,
                                            const vvec3fn<OW> &direction,
                                            const vrange1fn<OW> &tRange,
+                                           const float *times,
                                            VKLValueSelector valueSelector)
     {
       throw std::runtime_error(
@@ -610,6 +1117,8 @@ namespace openvkl {
     ISPCDriver<W>::computeSampleAnyWidth(const int *valid,
                                          VKLVolume volume,
                                          const vvec3fn<OW> &objectCoordinates,
+                                         const float *times,
+                                         const float *lods,
                                          float *samples)
     {
       auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
@@ -624,7 +1133,19 @@ namespace openvkl {
 
       vfloatn<W> samplesW;
 
-      volumeObject.computeSampleV(validW, ocW, samplesW);
+      if (times) {
+        vfloatn<W> timesW;
+        for (int i = 0; i < W; i++)
+          timesW[i] = i < OW ? times[i] : 0.f;
+        volumeObject.computeSampleTimeV(validW, ocW, timesW, samplesW);
+      } else if (lods) {
+        vfloatn<W> lodsW;
+        for (int i = 0; i < W; i++)
+          lodsW[i] = i < OW ? lods[i] : 0.f;
+        volumeObject.computeSampleLodV(validW, ocW, lodsW, samplesW);
+      } else {
+        volumeObject.computeSampleV(validW, ocW, samplesW);
+      }
 
       for (int i = 0; i < OW; i++)
         samples[i] = samplesW[i];
@@ -636,6 +1157,8 @@ namespace openvkl {
     ISPCDriver<W>::computeSampleAnyWidth(const int *valid,
                                          VKLVolume volume,
                                          const vvec3fn<OW> &objectCoordinates,
+                                         const float *times,
+                                         const float *lods,
                                          float *samples)
     {
       auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
@@ -646,7 +1169,21 @@ namespace openvkl {
 
       vfloatn<W> samplesW;
 
-      volumeObject.computeSampleV(validW, objectCoordinates, samplesW);
+      if (times) {
+        vfloatn<W> timesW;
+        for (int i = 0; i < W; i++)
+          timesW[i] = times[i];
+        volumeObject.computeSampleTimeV(
+            validW, objectCoordinates, timesW, samplesW);
+      } else if (lods) {
+        vfloatn<W> lodsW;
+        for (int i = 0; i < W; i++)
+          lodsW[i] = lods[i];
+        volumeObject.computeSampleLodV(
+            validW, objectCoordinates, lodsW, samplesW);
+      } else {
+        volumeObject.computeSampleV(validW, objectCoordinates, samplesW);
+      }
 
       for (int i = 0; i < W; i++)
         samples[i] = samplesW[i];
@@ -658,6 +1195,8 @@ namespace openvkl {
     ISPCDriver<W>::computeSampleAnyWidth(const int *valid,
                                          VKLVolume volume,
                                          const vvec3fn<OW> &objectCoordinates,
+                                         const float *times,
+                                         const float *lods,
                                          float *samples)
     {
       auto &volumeObject = referenceFromHandle<Volume<W>>(volume);
@@ -675,7 +1214,19 @@ namespace openvkl {
 
         vfloatn<W> samplesW;
 
-        volumeObject.computeSampleV(validW, ocW, samplesW);
+        if (times) {
+          vfloatn<W> timesW;
+          for (int i = packIndex * W; i < (packIndex + 1) * W; i++)
+            timesW[i - packIndex * W] = i < OW ? times[i] : 0.f;
+          volumeObject.computeSampleTimeV(validW, ocW, timesW, samplesW);
+        } else if (lods) {
+          vfloatn<W> lodsW;
+          for (int i = packIndex * W; i < (packIndex + 1) * W; i++)
+            lodsW[i - packIndex * W] = i < OW ? lods[i] : 0.f;
+          volumeObject.computeSampleLodV(validW, ocW, lodsW, samplesW);
+        } else {
+          volumeObject.computeSampleV(validW, ocW, samplesW);
+        }
 
         for (int i = packIndex * W; i < (packIndex + 1) * W && i < OW; i++)
           samples[i] = samplesW[i - packIndex * W];
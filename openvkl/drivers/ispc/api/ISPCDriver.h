@@ -4,6 +4,8 @@
 #pragma once
 
 #include "../../../api/Driver.h"
+#include <mutex>
+#include "embree3/rtcore.h"
 
 namespace openvkl {
   namespace ispc_driver {
@@ -11,8 +13,8 @@ namespace openvkl {
     template <int W>
     struct ISPCDriver : public api::Driver
     {
-      ISPCDriver()           = default;
-      ~ISPCDriver() override = default;
+      ISPCDriver() = default;
+      ~ISPCDriver() override;
 
       bool supportsWidth(int width) override;
 
@@ -47,6 +49,8 @@ namespace openvkl {
       // Interval iterator ////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
 
+      size_t getIntervalIteratorSize(VKLVolume volume, int width) override;
+
       void initIntervalIterator1(vVKLIntervalIteratorN<1> &iterator,
                                  VKLVolume volume,
                                  const vvec3fn<1> &origin,
@@ -85,10 +89,35 @@ namespace openvkl {
 
 #undef __define_iterateIntervalN
 
+      void getIntervalIteratorCheckpoint1(
+          const vVKLIntervalIteratorN<1> &iterator,
+          VKLIntervalIteratorCheckpoint &checkpoint) override;
+
+      void resumeIntervalIterator1(
+          vVKLIntervalIteratorN<1> &iterator,
+          VKLVolume volume,
+          const vvec3fn<1> &origin,
+          const vvec3fn<1> &direction,
+          const vrange1fn<1> &tRange,
+          const VKLIntervalIteratorCheckpoint &checkpoint,
+          VKLValueSelector valueSelector) override;
+
+      void iterateIntervalStream(VKLVolume volume,
+                                 size_t numRays,
+                                 const vkl_vec3f *origins,
+                                 const vkl_vec3f *directions,
+                                 const vkl_range1f *tRanges,
+                                 VKLValueSelector valueSelector,
+                                 size_t maxIntervalsPerRay,
+                                 VKLInterval *intervals,
+                                 uint32_t *numIntervals) override;
+
       /////////////////////////////////////////////////////////////////////////
       // Hit iterator /////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
 
+      size_t getHitIteratorSize(VKLVolume volume, int width) override;
+
       void initHitIterator1(vVKLHitIteratorN<1> &iterator,
                             VKLVolume volume,
                             const vvec3fn<1> &origin,
@@ -111,6 +140,30 @@ namespace openvkl {
 
 #undef __define_initHitIteratorN
 
+      void initHitIteratorTime1(vVKLHitIteratorN<1> &iterator,
+                                VKLVolume volume,
+                                const vvec3fn<1> &origin,
+                                const vvec3fn<1> &direction,
+                                const vrange1fn<1> &tRange,
+                                const float *time,
+                                VKLValueSelector valueSelector) override;
+
+#define __define_initHitIteratorTimeN(WIDTH)                         \
+  void initHitIteratorTime##WIDTH(const int *valid,                  \
+                                  vVKLHitIteratorN<WIDTH> &iterator, \
+                                  VKLVolume volume,                  \
+                                  const vvec3fn<WIDTH> &origin,      \
+                                  const vvec3fn<WIDTH> &direction,   \
+                                  const vrange1fn<WIDTH> &tRange,    \
+                                  const float *times,                \
+                                  VKLValueSelector valueSelector) override;
+
+      __define_initHitIteratorTimeN(4);
+      __define_initHitIteratorTimeN(8);
+      __define_initHitIteratorTimeN(16);
+
+#undef __define_initHitIteratorTimeN
+
       void iterateHit1(vVKLHitIteratorN<1> &iterator,
                        vVKLHitN<1> &hit,
                        int *result) override;
@@ -168,6 +221,19 @@ namespace openvkl {
           VKLValueSelector valueSelector,
           const utility::ArrayView<const float> &values) override;
 
+      void valueSelectorSetTransferFunction(
+          VKLValueSelector valueSelector,
+          const range1f &valueRange,
+          const utility::ArrayView<const float> &opacities) override;
+
+      void valueSelectorSetClipBoxes(
+          VKLValueSelector valueSelector,
+          const utility::ArrayView<const box3f> &boxes) override;
+
+      void valueSelectorSetClipPlanes(
+          VKLValueSelector valueSelector,
+          const utility::ArrayView<const vec4f> &planes) override;
+
       /////////////////////////////////////////////////////////////////////////
       // Volume ///////////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
@@ -187,6 +253,42 @@ namespace openvkl {
 
 #undef __define_computeSampleN
 
+#define __define_computeSampleTimeN(WIDTH)                               \
+  void computeSampleTime##WIDTH(const int *valid,                        \
+                                VKLVolume volume,                        \
+                                const vvec3fn<WIDTH> &objectCoordinates, \
+                                const float *times,                      \
+                                float *samples) override;
+
+      __define_computeSampleTimeN(1);
+      __define_computeSampleTimeN(4);
+      __define_computeSampleTimeN(8);
+      __define_computeSampleTimeN(16);
+
+#undef __define_computeSampleTimeN
+
+#define __define_computeSampleLodN(WIDTH)                               \
+  void computeSampleLod##WIDTH(const int *valid,                        \
+                               VKLVolume volume,                        \
+                               const vvec3fn<WIDTH> &objectCoordinates, \
+                               const float *lods,                       \
+                               float *samples) override;
+
+      __define_computeSampleLodN(1);
+      __define_computeSampleLodN(4);
+      __define_computeSampleLodN(8);
+      __define_computeSampleLodN(16);
+
+#undef __define_computeSampleLodN
+
+      void sampleRay(VKLVolume volume,
+                     const vvec3fn<1> &origin,
+                     const vvec3fn<1> &direction,
+                     float t0,
+                     float dt,
+                     unsigned int numSamples,
+                     float *samples) override;
+
 #define __define_computeGradientN(WIDTH)                               \
   void computeGradient##WIDTH(const int *valid,                        \
                               VKLVolume volume,                        \
@@ -202,9 +304,25 @@ namespace openvkl {
 
       box3f getBoundingBox(VKLVolume volume) override;
 
+      box3f getActiveBoundingBox(VKLVolume volume) override;
+
       range1f getValueRange(VKLVolume volume) override;
 
+      /////////////////////////////////////////////////////////////////////////
+      // Embree device ////////////////////////////////////////////////////////
+      /////////////////////////////////////////////////////////////////////////
+
+      // Embree device shared by all volumes of this driver which build BVHs;
+      // created on first use and sized to the driver's numThreads
+      RTCDevice getEmbreeDevice();
+
      private:
+      void releaseEmbreeDevice();
+
+      RTCDevice embreeDevice{nullptr};
+      int embreeDeviceNumThreads{-1};
+      std::mutex embreeDeviceMutex;
+
       template <int OW>
       typename std::enable_if<(OW == W), void>::type
       initIntervalIteratorAnyWidth(const int *valid,
@@ -247,6 +365,7 @@ namespace openvkl {
           const vvec3fn<OW> &origin,
           const vvec3fn<OW> &direction,
           const vrange1fn<OW> &tRange,
+          const float *times,
           VKLValueSelector valueSelector);
 
       template <int OW>
@@ -257,6 +376,7 @@ namespace openvkl {
                               const vvec3fn<OW> &origin,
                               const vvec3fn<OW> &direction,
                               const vrange1fn<OW> &tRange,
+                              const float *times,
                               VKLValueSelector valueSelector);
 
       template <int OW>
@@ -278,6 +398,8 @@ namespace openvkl {
           const int *valid,
           VKLVolume volume,
           const vvec3fn<OW> &objectCoordinates,
+          const float *times,
+          const float *lods,
           float *samples);
 
       template <int OW>
@@ -285,6 +407,8 @@ namespace openvkl {
           const int *valid,
           VKLVolume volume,
           const vvec3fn<OW> &objectCoordinates,
+          const float *times,
+          const float *lods,
           float *samples);
 
       template <int OW>
@@ -292,6 +416,8 @@ namespace openvkl {
           const int *valid,
           VKLVolume volume,
           const vvec3fn<OW> &objectCoordinates,
+          const float *times,
+          const float *lods,
           float *samples);
 
       template <int OW>
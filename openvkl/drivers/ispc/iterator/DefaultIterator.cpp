@@ -47,6 +47,8 @@ namespace openvkl {
 
       box3f boundingBox = volume->getBoundingBox();
 
+      box3f activeBoundingBox = volume->getActiveBoundingBox();
+
       range1f valueRange = volume->getValueRange();
 
       CALL_ISPC(DefaultIterator_Initialize,
@@ -58,6 +60,7 @@ namespace openvkl {
                 (void *)&tRange,
                 valueSelector ? valueSelector->getISPCEquivalent() : nullptr,
                 (const ispc::box3f &)boundingBox,
+                (const ispc::box3f &)activeBoundingBox,
                 (const ispc::box1f &)valueRange);
     }
 
@@ -78,6 +81,26 @@ namespace openvkl {
                 static_cast<int *>(result));
     }
 
+    template <int W>
+    void DefaultIterator<W>::getCheckpoint(
+        int lane, VKLIntervalIteratorCheckpoint &checkpoint) const
+    {
+      CALL_ISPC(DefaultIterator_getCheckpoint,
+                (void *)&ispcStorage[0],
+                lane,
+                &checkpoint);
+    }
+
+    template <int W>
+    void DefaultIterator<W>::resumeFromCheckpoint(
+        int lane, const VKLIntervalIteratorCheckpoint &checkpoint)
+    {
+      CALL_ISPC(DefaultIterator_resumeFromCheckpoint,
+                (void *)&ispcStorage[0],
+                lane,
+                (void *)&checkpoint);
+    }
+
     template <int W>
     const Hit<W> *DefaultIterator<W>::getCurrentHit() const
     {
@@ -24,6 +24,11 @@ namespace openvkl {
       const Interval<W> *getCurrentInterval() const override;
       void iterateInterval(const vintn<W> &valid, vintn<W> &result) override;
 
+      void getCheckpoint(
+          int lane, VKLIntervalIteratorCheckpoint &checkpoint) const override;
+      void resumeFromCheckpoint(
+          int lane, const VKLIntervalIteratorCheckpoint &checkpoint) override;
+
       const Hit<W> *getCurrentHit() const override;
       void iterateHit(const vintn<W> &valid, vintn<W> &result) override;
 
@@ -77,6 +77,24 @@ namespace openvkl {
                 static_cast<int *>(result));
     }
 
+    template <int W>
+    void GridAcceleratorIteratorU<W>::getCheckpoint(
+        VKLIntervalIteratorCheckpoint &checkpoint) const
+    {
+      CALL_ISPC(GridAcceleratorIteratorU_getCheckpoint,
+                (void *)&ispcStorage[0],
+                &checkpoint);
+    }
+
+    template <int W>
+    void GridAcceleratorIteratorU<W>::resumeFromCheckpoint(
+        const VKLIntervalIteratorCheckpoint &checkpoint)
+    {
+      CALL_ISPC(GridAcceleratorIteratorU_resumeFromCheckpoint,
+                (void *)&ispcStorage[0],
+                (void *)&checkpoint);
+    }
+
     template <int W>
     const Hit<1> *GridAcceleratorIteratorU<W>::getCurrentHit() const
     {
@@ -163,6 +181,26 @@ namespace openvkl {
                 static_cast<int *>(result));
     }
 
+    template <int W>
+    void GridAcceleratorIteratorV<W>::getCheckpoint(
+        int lane, VKLIntervalIteratorCheckpoint &checkpoint) const
+    {
+      CALL_ISPC(GridAcceleratorIteratorV_getCheckpoint,
+                (void *)&ispcStorage[0],
+                lane,
+                &checkpoint);
+    }
+
+    template <int W>
+    void GridAcceleratorIteratorV<W>::resumeFromCheckpoint(
+        int lane, const VKLIntervalIteratorCheckpoint &checkpoint)
+    {
+      CALL_ISPC(GridAcceleratorIteratorV_resumeFromCheckpoint,
+                (void *)&ispcStorage[0],
+                lane,
+                (void *)&checkpoint);
+    }
+
     template <int W>
     const Hit<W> *GridAcceleratorIteratorV<W>::getCurrentHit() const
     {
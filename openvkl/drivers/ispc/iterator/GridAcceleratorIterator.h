@@ -24,12 +24,17 @@ namespace openvkl {
       const Interval<1> *getCurrentInterval() const override;
       void iterateInterval(vintn<1> &result) override;
 
+      void getCheckpoint(
+          VKLIntervalIteratorCheckpoint &checkpoint) const override;
+      void resumeFromCheckpoint(
+          const VKLIntervalIteratorCheckpoint &checkpoint) override;
+
       const Hit<1> *getCurrentHit() const override;
       void iterateHit(vintn<1> &result) override;
 
       // required size of ISPC-side object for width; exported to support
       // functional tests
-      static constexpr int OPENVKL_DLLEXPORT ispcStorageSize = 120;
+      static constexpr int OPENVKL_DLLEXPORT ispcStorageSize = 136;
 
      protected:
       alignas(simd_alignment_for_width(W)) char ispcStorage[ispcStorageSize];
@@ -52,12 +57,17 @@ namespace openvkl {
       const Interval<W> *getCurrentInterval() const override;
       void iterateInterval(const vintn<W> &valid, vintn<W> &result) override;
 
+      void getCheckpoint(
+          int lane, VKLIntervalIteratorCheckpoint &checkpoint) const override;
+      void resumeFromCheckpoint(
+          int lane, const VKLIntervalIteratorCheckpoint &checkpoint) override;
+
       const Hit<W> *getCurrentHit() const override;
       void iterateHit(const vintn<W> &valid, vintn<W> &result) override;
 
       // required size of ISPC-side object for width; exported to support
       // functional tests
-      static constexpr int OPENVKL_DLLEXPORT ispcStorageSize = 112 * W;
+      static constexpr int OPENVKL_DLLEXPORT ispcStorageSize = 124 * W;
 
      protected:
       alignas(simd_alignment_for_width(W)) char ispcStorage[ispcStorageSize];
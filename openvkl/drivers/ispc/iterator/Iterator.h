@@ -21,6 +21,7 @@ namespace openvkl {
       vrange1fn<W> tRange;
       vrange1fn<W> valueRange;
       vfloatn<W> nominalDeltaT;
+      vfloatn<W> majorant;
     };
 
     template <int W>
@@ -106,6 +107,13 @@ namespace openvkl {
       virtual const Interval<1> *getCurrentInterval() const = 0;
       virtual void iterateInterval(vintn<1> &result)        = 0;
 
+      // Interval iterator checkpoints; resumeFromCheckpoint() is called on a
+      // freshly initialized iterator.
+      virtual void getCheckpoint(
+          VKLIntervalIteratorCheckpoint &checkpoint) const = 0;
+      virtual void resumeFromCheckpoint(
+          const VKLIntervalIteratorCheckpoint &checkpoint) = 0;
+
       virtual const Hit<1> *getCurrentHit() const = 0;
       virtual void iterateHit(vintn<1> &result)   = 0;
 
@@ -146,6 +154,13 @@ namespace openvkl {
       virtual const Interval<W> *getCurrentInterval() const                 = 0;
       virtual void iterateInterval(const vintn<W> &valid, vintn<W> &result) = 0;
 
+      // Interval iterator checkpoints for the given lane;
+      // resumeFromCheckpoint() is called on a freshly initialized iterator.
+      virtual void getCheckpoint(
+          int lane, VKLIntervalIteratorCheckpoint &checkpoint) const = 0;
+      virtual void resumeFromCheckpoint(
+          int lane, const VKLIntervalIteratorCheckpoint &checkpoint) = 0;
+
       virtual const Hit<W> *getCurrentHit() const                      = 0;
       virtual void iterateHit(const vintn<W> &valid, vintn<W> &result) = 0;
 
@@ -71,6 +71,26 @@ namespace openvkl {
                 static_cast<int *>(result));
     }
 
+    template <int W>
+    void UnstructuredIterator<W>::getCheckpoint(
+        int lane, VKLIntervalIteratorCheckpoint &checkpoint) const
+    {
+      CALL_ISPC(UnstructuredIterator_getCheckpoint,
+                (void *)&ispcStorage[0],
+                lane,
+                &checkpoint);
+    }
+
+    template <int W>
+    void UnstructuredIterator<W>::resumeFromCheckpoint(
+        int lane, const VKLIntervalIteratorCheckpoint &checkpoint)
+    {
+      CALL_ISPC(UnstructuredIterator_resumeFromCheckpoint,
+                (void *)&ispcStorage[0],
+                lane,
+                (void *)&checkpoint);
+    }
+
     template <int W>
     const Hit<W> *UnstructuredIterator<W>::getCurrentHit() const
     {
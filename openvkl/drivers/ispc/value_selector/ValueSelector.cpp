@@ -5,6 +5,9 @@
 #include "../common/export_util.h"
 #include "../volume/Volume.h"
 #include "ValueSelector_ispc.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 
 namespace openvkl {
   namespace ispc_driver {
@@ -29,12 +32,52 @@ namespace openvkl {
         CALL_ISPC(ValueSelector_Destructor, ispcEquivalent);
       }
 
+      // Iterators binary search the ranges and values, so sort the ranges
+      // and merge overlapping ones, and sort the values and remove
+      // duplicates. Empty ranges and NaN values cannot select anything.
+      std::vector<range1f> sortedRanges;
+      std::copy_if(ranges.begin(),
+                   ranges.end(),
+                   std::back_inserter(sortedRanges),
+                   [](const range1f &r) { return r.lower <= r.upper; });
+      std::sort(sortedRanges.begin(),
+                sortedRanges.end(),
+                [](const range1f &a, const range1f &b) {
+                  return a.lower < b.lower;
+                });
+
+      std::vector<range1f> mergedRanges;
+      for (const range1f &r : sortedRanges) {
+        if (!mergedRanges.empty() && r.lower <= mergedRanges.back().upper) {
+          mergedRanges.back().upper =
+              std::max(mergedRanges.back().upper, r.upper);
+        } else {
+          mergedRanges.push_back(r);
+        }
+      }
+
+      std::vector<float> sortedValues;
+      std::copy_if(values.begin(),
+                   values.end(),
+                   std::back_inserter(sortedValues),
+                   [](float v) { return !std::isnan(v); });
+      std::sort(sortedValues.begin(), sortedValues.end());
+      sortedValues.erase(std::unique(sortedValues.begin(), sortedValues.end()),
+                         sortedValues.end());
+
       ispcEquivalent = CALL_ISPC(ValueSelector_Constructor,
                                  nullptr,
-                                 ranges.size(),
-                                 (const ispc::box1f *)ranges.data(),
-                                 values.size(),
-                                 (const float *)values.data());
+                                 mergedRanges.size(),
+                                 (const ispc::box1f *)mergedRanges.data(),
+                                 sortedValues.size(),
+                                 (const float *)sortedValues.data(),
+                                 opacities.size(),
+                                 (const float *)opacities.data(),
+                                 (const ispc::box1f &)opacityValueRange,
+                                 clipBoxes.size(),
+                                 (const ispc::box3f *)clipBoxes.data(),
+                                 clipPlanes.size(),
+                                 (const ispc::vec4f *)clipPlanes.data());
     }
 
     template <int W>
@@ -59,6 +102,39 @@ namespace openvkl {
       }
     }
 
+    template <int W>
+    void ValueSelector<W>::setTransferFunction(
+        const range1f &valueRange,
+        const utility::ArrayView<const float> &opacities)
+    {
+      if (opacities.size() > 1 && !(valueRange.upper > valueRange.lower)) {
+        throw std::runtime_error(
+            "transfer function value range must not be empty");
+      }
+
+      opacityValueRange = valueRange;
+      this->opacities.assign(opacities.begin(), opacities.end());
+    }
+
+    template <int W>
+    void ValueSelector<W>::setClipBoxes(
+        const utility::ArrayView<const box3f> &boxes)
+    {
+      // Empty boxes cannot clip anything.
+      clipBoxes.clear();
+      std::copy_if(boxes.begin(),
+                   boxes.end(),
+                   std::back_inserter(clipBoxes),
+                   [](const box3f &b) { return !b.empty(); });
+    }
+
+    template <int W>
+    void ValueSelector<W>::setClipPlanes(
+        const utility::ArrayView<const vec4f> &planes)
+    {
+      clipPlanes.assign(planes.begin(), planes.end());
+    }
+
     template struct ValueSelector<VKL_TARGET_WIDTH>;
 
   }  // namespace ispc_driver
@@ -5,6 +5,7 @@
 
 #include "../common/ManagedObject.h"
 #include "../common/objectFactory.h"
+#include "ospcommon/math/box.h"
 #include "ospcommon/math/range.h"
 #include "ospcommon/utility/ArrayView.h"
 
@@ -27,6 +28,10 @@ namespace openvkl {
 
       void setRanges(const utility::ArrayView<const range1f> &ranges);
       void setValues(const utility::ArrayView<const float> &values);
+      void setTransferFunction(const range1f &valueRange,
+                               const utility::ArrayView<const float> &opacities);
+      void setClipBoxes(const utility::ArrayView<const box3f> &boxes);
+      void setClipPlanes(const utility::ArrayView<const vec4f> &planes);
 
       void *getISPCEquivalent() const;
 
@@ -36,6 +41,12 @@ namespace openvkl {
       std::vector<range1f> ranges;
       std::vector<float> values;
 
+      range1f opacityValueRange;
+      std::vector<float> opacities;
+
+      std::vector<box3f> clipBoxes;
+      std::vector<vec4f> clipPlanes;
+
       void *ispcEquivalent{nullptr};
     };
 
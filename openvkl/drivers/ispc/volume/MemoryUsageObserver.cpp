@@ -0,0 +1,39 @@
+// Copyright 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "MemoryUsageObserver.h"
+
+namespace openvkl {
+  namespace ispc_driver {
+
+    MemoryUsageObserver::MemoryUsageObserver(ManagedObject &target,
+                                             size_t bytesUsed)
+        : target(&target), bytesUsed(bytesUsed)
+    {
+      this->target->refInc();
+    }
+
+    MemoryUsageObserver::~MemoryUsageObserver()
+    {
+      target->refDec();
+    }
+
+    const void *MemoryUsageObserver::map()
+    {
+      return &bytesUsed;
+    }
+
+    void MemoryUsageObserver::unmap() {}
+
+    size_t MemoryUsageObserver::getNumElements() const
+    {
+      return 1;
+    }
+
+    VKLDataType MemoryUsageObserver::getElementType() const
+    {
+      return VKL_ULONG;
+    }
+
+  }  // namespace ispc_driver
+}  // namespace openvkl
@@ -0,0 +1,40 @@
+// Copyright 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../common/Observer.h"
+#include "openvkl/ispc_cpp_interop.h"
+
+namespace openvkl {
+  namespace ispc_driver {
+
+    /*
+     * The memory usage observer reports the number of bytes of internal
+     * storage (acceleration structures and derived data, but not shared
+     * application buffers) held by a volume at the time the observer was
+     * created. It maps to a single VKL_ULONG element.
+     */
+    struct MemoryUsageObserver : public Observer
+    {
+      MemoryUsageObserver(ManagedObject &target, size_t bytesUsed);
+
+      MemoryUsageObserver(MemoryUsageObserver &&) = delete;
+      MemoryUsageObserver &operator=(MemoryUsageObserver &&) = delete;
+      MemoryUsageObserver(const MemoryUsageObserver &)       = delete;
+      MemoryUsageObserver &operator=(const MemoryUsageObserver &) = delete;
+
+      ~MemoryUsageObserver();
+
+      const void *map() override;
+      void unmap() override;
+      VKLDataType getElementType() const override;
+      size_t getNumElements() const override;
+
+     private:
+      ManagedObject *target{nullptr};
+      vkl_uint64 bytesUsed{0};
+    };
+
+  }  // namespace ispc_driver
+}  // namespace openvkl
@@ -28,7 +28,8 @@ namespace openvkl {
                                (const ispc::vec3i &)this->dimensions,
                                ispc::structured_regular,
                                (const ispc::vec3f &)this->gridOrigin,
-                               (const ispc::vec3f &)this->gridSpacing);
+                               (const ispc::vec3f &)this->gridSpacing,
+                               this->filter);
 
       if (!success) {
         CALL_ISPC(SharedStructuredVolume_Destructor, this->ispcEquivalent);
@@ -37,6 +38,10 @@ namespace openvkl {
         throw std::runtime_error("failed to commit StructuredRegularVolume");
       }
 
+      CALL_ISPC(SharedStructuredVolume_setExactHits,
+                this->ispcEquivalent,
+                this->template getParam<bool>("exactHits", false));
+
       // must be last
       this->buildAccelerator();
     }
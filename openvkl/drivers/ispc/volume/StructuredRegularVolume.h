@@ -14,6 +14,26 @@ namespace openvkl {
     {
       void commit() override;
 
+      size_t getIntervalIteratorSizeU() const override
+      {
+        return sizeof(GridAcceleratorIteratorU<W>);
+      }
+
+      size_t getIntervalIteratorSizeV() const override
+      {
+        return sizeof(GridAcceleratorIteratorV<W>);
+      }
+
+      size_t getHitIteratorSizeU() const override
+      {
+        return sizeof(GridAcceleratorIteratorU<W>);
+      }
+
+      size_t getHitIteratorSizeV() const override
+      {
+        return sizeof(GridAcceleratorIteratorV<W>);
+      }
+
       void initIntervalIteratorU(
           vVKLIntervalIteratorN<1> &iterator,
           const vvec3fn<1> &origin,
@@ -29,6 +49,18 @@ namespace openvkl {
           const vrange1fn<W> &tRange,
           const ValueSelector<W> *valueSelector) override;
 
+      void getIntervalIteratorCheckpointU(
+          const vVKLIntervalIteratorN<1> &iterator,
+          VKLIntervalIteratorCheckpoint &checkpoint) const override;
+
+      void resumeIntervalIteratorU(
+          vVKLIntervalIteratorN<1> &iterator,
+          const vvec3fn<1> &origin,
+          const vvec3fn<1> &direction,
+          const vrange1fn<1> &tRange,
+          const VKLIntervalIteratorCheckpoint &checkpoint,
+          const ValueSelector<W> *valueSelector) override;
+
       void iterateIntervalU(vVKLIntervalIteratorN<1> &iterator,
                             vVKLIntervalN<1> &interval,
                             vintn<1> &result) override;
@@ -88,6 +120,35 @@ namespace openvkl {
           iterator, valid, this, origin, direction, tRange, valueSelector);
     }
 
+    template <int W>
+    inline void StructuredRegularVolume<W>::getIntervalIteratorCheckpointU(
+        const vVKLIntervalIteratorN<1> &iterator,
+        VKLIntervalIteratorCheckpoint &checkpoint) const
+    {
+      const GridAcceleratorIteratorU<W> *ri =
+          fromVKLIntervalIterator<GridAcceleratorIteratorU<W>>(
+              const_cast<vVKLIntervalIteratorN<1> *>(&iterator));
+
+      ri->getCheckpoint(checkpoint);
+    }
+
+    template <int W>
+    inline void StructuredRegularVolume<W>::resumeIntervalIteratorU(
+        vVKLIntervalIteratorN<1> &iterator,
+        const vvec3fn<1> &origin,
+        const vvec3fn<1> &direction,
+        const vrange1fn<1> &tRange,
+        const VKLIntervalIteratorCheckpoint &checkpoint,
+        const ValueSelector<W> *valueSelector)
+    {
+      initIntervalIteratorU(iterator, origin, direction, tRange, valueSelector);
+
+      GridAcceleratorIteratorU<W> *ri =
+          fromVKLIntervalIterator<GridAcceleratorIteratorU<W>>(&iterator);
+
+      ri->resumeFromCheckpoint(checkpoint);
+    }
+
     template <int W>
     inline void StructuredRegularVolume<W>::iterateIntervalU(
         vVKLIntervalIteratorN<1> &iterator,
@@ -6,6 +6,7 @@
 #include "../common/Data.h"
 #include "../common/export_util.h"
 #include "../common/math.h"
+#include "openvkl/VKLFilter.h"
 #include "GridAccelerator_ispc.h"
 #include "SharedStructuredVolume_ispc.h"
 #include "Volume.h"
@@ -28,12 +29,21 @@ namespace openvkl {
                           const vvec3fn<W> &objectCoordinates,
                           vfloatn<W> &samples) const override;
 
+      void computeSampleRay(const vvec3fn<1> &origin,
+                            const vvec3fn<1> &direction,
+                            float t0,
+                            float dt,
+                            unsigned int numSamples,
+                            float *samples) const override;
+
       void computeGradientV(const vintn<W> &valid,
                             const vvec3fn<W> &objectCoordinates,
                             vvec3fn<W> &gradients) const override;
 
       box3f getBoundingBox() const override;
 
+      box3f getActiveBoundingBox() const override;
+
       range1f getValueRange() const override;
 
      protected:
@@ -45,6 +55,7 @@ namespace openvkl {
       vec3i dimensions;
       vec3f gridOrigin;
       vec3f gridSpacing;
+      VKLFilter filter{VKL_FILTER_TRILINEAR};
       Data *voxelData{nullptr};
     };
 
@@ -64,6 +75,14 @@ namespace openvkl {
       dimensions  = this->template getParam<vec3i>("dimensions", vec3i(128));
       gridOrigin  = this->template getParam<vec3f>("gridOrigin", vec3f(0.f));
       gridSpacing = this->template getParam<vec3f>("gridSpacing", vec3f(1.f));
+      filter      = (VKLFilter)this->template getParam<int>(
+          "filter", VKL_FILTER_TRILINEAR);
+
+      if (filter != VKL_FILTER_TRILINEAR && filter != VKL_FILTER_TRICUBIC) {
+        throw std::runtime_error(
+            "structured volumes support only the trilinear and tricubic "
+            "filters");
+      }
 
       voxelData = (Data *)this->template getParam<ManagedObject::VKL_PTR>(
           "data", nullptr);
@@ -101,6 +120,25 @@ namespace openvkl {
                 &samples);
     }
 
+    template <int W>
+    inline void StructuredVolume<W>::computeSampleRay(
+        const vvec3fn<1> &origin,
+        const vvec3fn<1> &direction,
+        float t0,
+        float dt,
+        unsigned int numSamples,
+        float *samples) const
+    {
+      CALL_ISPC(SharedStructuredVolume_sampleRay_export,
+                this->ispcEquivalent,
+                (const ispc::vec3f &)origin,
+                (const ispc::vec3f &)direction,
+                t0,
+                dt,
+                numSamples,
+                samples);
+    }
+
     template <int W>
     inline void StructuredVolume<W>::computeGradientV(
         const vintn<W> &valid,
@@ -124,6 +162,16 @@ namespace openvkl {
                    vec3f(bb.upper.x, bb.upper.y, bb.upper.z));
     }
 
+    template <int W>
+    inline box3f StructuredVolume<W>::getActiveBoundingBox() const
+    {
+      ispc::box3f bb = CALL_ISPC(SharedStructuredVolume_getActiveBoundingBox,
+                                 this->ispcEquivalent);
+
+      return box3f(vec3f(bb.lower.x, bb.lower.y, bb.lower.z),
+                   vec3f(bb.upper.x, bb.upper.y, bb.upper.z));
+    }
+
     template <int W>
     inline range1f StructuredVolume<W>::getValueRange() const
     {
@@ -154,6 +202,8 @@ namespace openvkl {
                 accelerator,
                 valueRange.lower,
                 valueRange.upper);
+
+      CALL_ISPC(GridAccelerator_computeActiveBoundingBox, accelerator);
     }
 
   }  // namespace ispc_driver
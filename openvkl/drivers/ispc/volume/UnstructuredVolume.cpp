@@ -2,7 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "UnstructuredVolume.h"
+#include "../api/ISPCDriver.h"
 #include "../common/Data.h"
+#include "MemoryUsageObserver.h"
 #include "ospcommon/containers/AlignedVector.h"
 #include "ospcommon/tasking/parallel_for.h"
 
@@ -38,7 +40,8 @@ namespace openvkl {
       if (root->nominalLength < 0) {
         auto leaf = (LeafNode *)root;
         tabIndent(indent);
-        std::cerr << "id: " << leaf->cellID << " bounds: " << leaf->bounds
+        std::cerr << "cells: " << leaf->numCells << " first id: "
+                  << leaf->cellIDs[0] << " bounds: " << leaf->bounds
                   << " range: " << leaf->valueRange
                   << " nom: " << leaf->nominalLength << std::endl;
       } else {
@@ -57,13 +60,41 @@ namespace openvkl {
       }
     }
 
+    static size_t bvhMemoryUsage(const Node *root)
+    {
+      if (root->nominalLength < 0) {
+        auto leaf = (const LeafNode *)root;
+        return sizeof(LeafNode) + leaf->numCells * sizeof(uint64_t);
+      } else {
+        auto inner = (const InnerNode *)root;
+        return sizeof(InnerNode) + bvhMemoryUsage(inner->children[0]) +
+               bvhMemoryUsage(inner->children[1]);
+      }
+    }
+
+    // Union of the bounds of leaves with non-zero values; subtrees without
+    // non-zero values are skipped.
+    static box3f activeNodeBounds(const Node *node)
+    {
+      if (!(node->valueRange.lower < 0.f || node->valueRange.upper > 0.f))
+        return box3f(empty);
+
+      if (node->nominalLength < 0) {
+        auto &val = ((const LeafNode *)node)->bounds;
+        return box3f(val.lower, val.upper);
+      }
+
+      auto inner = (const InnerNode *)node;
+      box3f bounds = activeNodeBounds(inner->children[0]);
+      bounds.extend(activeNodeBounds(inner->children[1]));
+      return bounds;
+    }
+
     template <int W>
     UnstructuredVolume<W>::~UnstructuredVolume()
     {
       if (rtcBVH)
         rtcReleaseBVH(rtcBVH);
-      if (rtcDevice)
-        rtcReleaseDevice(rtcDevice);
     }
 
     template <int W>
@@ -109,7 +140,17 @@ namespace openvkl {
             "'indexPrefixed'");
       }
 
-      if (vertexPosition->dataType != VKL_VEC3F) {
+      switch (vertexPosition->dataType) {
+      case VKL_VEC3F:
+        break;
+      case VKL_USHORT:
+        if (vertexPosition->size() % 3 != 0) {
+          throw std::runtime_error(
+              "unstructured volume quantized 'vertex.position' must have "
+              "three values per vertex");
+        }
+        break;
+      default:
         throw std::runtime_error("unstructured volume unsupported vertex type");
       }
 
@@ -168,6 +209,45 @@ namespace openvkl {
 
       hexIterative = this->template getParam<bool>("hexIterative", false);
 
+      bvhBuildQuality =
+          this->template getParam<std::string>("bvhBuildQuality", "medium");
+      maxLeafSize = this->template getParam<int>("maxLeafSize", 1);
+
+      if (maxLeafSize < 1) {
+        throw std::runtime_error(
+            "unstructured volume 'maxLeafSize' must be at least 1");
+      }
+
+      // positions given as 16-bit integers are used as they are, float
+      // positions are quantized into internal storage on request
+      const bool sharedQuantized = vertexPosition->dataType == VKL_USHORT;
+      const bool quantize =
+          sharedQuantized ||
+          this->template getParam<bool>("quantizeVertices", false);
+
+      // normals cached from a previous commit are derived from the previous
+      // vertex representation, and the quantization frame may have changed
+      if (quantize || quantizedPositions) {
+        faceNormals.clear();
+      }
+
+      if (sharedQuantized) {
+        quantizedVertices.clear();
+        quantizedVertices.shrink_to_fit();
+        quantizedPositions = (const uint16_t *)vertexPosition->data;
+        quantizationOrigin =
+            this->template getParam<vec3f>("quantizationOrigin", vec3f(0.f));
+        quantizationScale =
+            this->template getParam<vec3f>("quantizationScale", vec3f(1.f));
+      } else if (quantize) {
+        quantizeVertexPositions();
+        quantizedPositions = quantizedVertices.data();
+      } else {
+        quantizedVertices.clear();
+        quantizedVertices.shrink_to_fit();
+        quantizedPositions = nullptr;
+      }
+
       bool needTolerances = false;
       for (int i = 0; i < nCells; i++) {
         auto cell = ((uint8_t *)cellType->data)[i];
@@ -204,7 +284,11 @@ namespace openvkl {
           VKLUnstructuredVolume_set,
           this->ispcEquivalent,
           (const ispc::box3f &)bounds,
-          (const ispc::vec3f *)vertexPosition->data,
+          quantizedPositions ? nullptr
+                             : (const ispc::vec3f *)vertexPosition->data,
+          quantizedPositions,
+          (const ispc::vec3f &)quantizationOrigin,
+          (const ispc::vec3f &)quantizationScale,
           (const uint32_t *)index->data,
           index32Bit,
           vertexValue ? (const float *)vertexValue->data : nullptr,
@@ -234,7 +318,7 @@ namespace openvkl {
         uint64_t vId = getVertexId(cOffset + i);
 
         // build 4 dimensional vertex with its position and value
-        vec3f &v  = ((vec3f *)(vertexPosition->data))[vId];
+        const vec3f v = getVertex(vId);
         float val = cellValue ? ((float *)(cellValue->data))[id]
                               : ((float *)(vertexValue->data))[vId];
         vec4f p = vec4f(v.x, v.y, v.z, val);
@@ -249,20 +333,36 @@ namespace openvkl {
       return bBox;
     }
 
-    static inline void errorFunction(void *userPtr, enum RTCError error, const char *str)
+    template <int W>
+    RTCBuildQuality UnstructuredVolume<W>::getBvhBuildQuality() const
     {
-      LogMessageStream(VKL_LOG_WARNING)
-          << "error " << error << ": " << str << std::endl;
+      if (bvhBuildQuality == "low") {
+        return RTC_BUILD_QUALITY_LOW;
+      } else if (bvhBuildQuality == "medium") {
+        return RTC_BUILD_QUALITY_MEDIUM;
+      } else if (bvhBuildQuality == "high") {
+        return RTC_BUILD_QUALITY_HIGH;
+      }
+
+      throw std::runtime_error(
+          "unstructured volume 'bvhBuildQuality' must be one of 'low', "
+          "'medium' or 'high'");
     }
 
     template <int W>
     void UnstructuredVolume<W>::buildBvhAndCalculateBounds()
     {
-      rtcDevice = rtcNewDevice(NULL);
-      if (!rtcDevice) {
-        throw std::runtime_error("cannot create device");
+      // all BVHs share the driver's Embree device (and its thread pool)
+      RTCDevice rtcDevice =
+          static_cast<ISPCDriver<W> &>(api::currentDriver()).getEmbreeDevice();
+
+      const RTCBuildQuality buildQuality = getBvhBuildQuality();
+
+      if (rtcBVH) {
+        rtcReleaseBVH(rtcBVH);
+        rtcBVH  = nullptr;
+        rtcRoot = nullptr;
       }
-      rtcSetDeviceErrorFunction(rtcDevice, errorFunction, NULL);
 
       containers::AlignedVector<RTCBuildPrimitive> prims;
       containers::AlignedVector<range1f> range;
@@ -290,12 +390,12 @@ namespace openvkl {
       RTCBuildArguments arguments      = rtcDefaultBuildArguments();
       arguments.byteSize               = sizeof(arguments);
       arguments.buildFlags             = RTC_BUILD_FLAG_NONE;
-      arguments.buildQuality           = RTC_BUILD_QUALITY_MEDIUM;
+      arguments.buildQuality           = buildQuality;
       arguments.maxBranchingFactor     = 2;
       arguments.maxDepth               = 1024;
       arguments.sahBlockSize           = 1;
       arguments.minLeafSize            = 1;
-      arguments.maxLeafSize            = 1;
+      arguments.maxLeafSize            = maxLeafSize;
       arguments.traversalCost          = 1.0f;
       arguments.intersectionCost       = 10.0f;
       arguments.bvh                    = rtcBVH;
@@ -324,6 +424,8 @@ namespace openvkl {
         bounds.extend(box3f(vals[1].lower, vals[1].upper));
       }
       valueRange = rtcRoot->valueRange;
+
+      activeBounds = activeNodeBounds(rtcRoot);
     }
 
     template <int W>
@@ -374,8 +476,8 @@ namespace openvkl {
       for (int i = 0; i < count; i++) {
         uint64_t vId0    = getVertexId(cOffset + edge[i][0]);
         uint64_t vId1    = getVertexId(cOffset + edge[i][1]);
-        const vec3f &v0  = ((const vec3f *)(vertexPosition->data))[vId0];
-        const vec3f &v1  = ((const vec3f *)(vertexPosition->data))[vId1];
+        const vec3f v0   = getVertex(vId0);
+        const vec3f v1   = getVertex(vId1);
         const float dist = length(v0 - v1);
         longest          = std::max(longest, dist);
       }
@@ -440,15 +542,96 @@ namespace openvkl {
         uint64_t vId0   = getVertexId(cOffset + faces[i][0]);
         uint64_t vId1   = getVertexId(cOffset + faces[i][1]);
         uint64_t vId2   = getVertexId(cOffset + faces[i][2]);
-        const vec3f &v0 = ((const vec3f *)(vertexPosition->data))[vId0];
-        const vec3f &v1 = ((const vec3f *)(vertexPosition->data))[vId1];
-        const vec3f &v2 = ((const vec3f *)(vertexPosition->data))[vId2];
+        const vec3f v0  = getVertex(vId0);
+        const vec3f v1  = getVertex(vId1);
+        const vec3f v2  = getVertex(vId2);
 
         // Calculate normal
         faceNormals[cellId * 6 + i] = normalize(cross(v0 - v1, v2 - v1));
       }
     }
 
+    template <int W>
+    void UnstructuredVolume<W>::quantizeVertexPositions()
+    {
+      const uint64_t numVertices = vertexPosition->size();
+      const vec3f *vertices      = (const vec3f *)vertexPosition->data;
+
+      // global quantization frame: per-block bounds, reduced serially
+      constexpr uint64_t blockSize = 1 << 16;
+      const uint64_t numBlocks     = (numVertices + blockSize - 1) / blockSize;
+
+      std::vector<box3f> blockBounds(numBlocks, box3f(empty));
+
+      tasking::parallel_for(numBlocks, [&](uint64_t blockIndex) {
+        const uint64_t begin = blockIndex * blockSize;
+        const uint64_t end   = std::min(begin + blockSize, numVertices);
+        for (uint64_t i = begin; i < end; i++)
+          blockBounds[blockIndex].extend(vertices[i]);
+      });
+
+      box3f vertexBounds(empty);
+      for (const auto &b : blockBounds)
+        vertexBounds.extend(b);
+
+      quantizationOrigin = vertexBounds.lower;
+      quantizationScale  = (vertexBounds.upper - vertexBounds.lower) / 65535.f;
+
+      const vec3f rcpScale(
+          quantizationScale.x > 0.f ? 1.f / quantizationScale.x : 0.f,
+          quantizationScale.y > 0.f ? 1.f / quantizationScale.y : 0.f,
+          quantizationScale.z > 0.f ? 1.f / quantizationScale.z : 0.f);
+
+      auto quantize = [](float v) -> uint16_t {
+        return uint16_t(clamp(v + 0.5f, 0.f, 65535.f));
+      };
+
+      quantizedVertices.resize(numVertices * 3);
+
+      tasking::parallel_for(numBlocks, [&](uint64_t blockIndex) {
+        const uint64_t begin = blockIndex * blockSize;
+        const uint64_t end   = std::min(begin + blockSize, numVertices);
+        for (uint64_t i = begin; i < end; i++) {
+          const vec3f q = (vertices[i] - quantizationOrigin) * rcpScale;
+          quantizedVertices[3 * i + 0] = quantize(q.x);
+          quantizedVertices[3 * i + 1] = quantize(q.y);
+          quantizedVertices[3 * i + 2] = quantize(q.z);
+        }
+      });
+    }
+
+    template <int W>
+    size_t UnstructuredVolume<W>::getMemoryUsage() const
+    {
+      size_t bytes = 0;
+
+      bytes += quantizedVertices.size() * sizeof(uint16_t);
+      bytes += faceNormals.size() * sizeof(vec3f);
+      bytes += iterativeTolerance.size() * sizeof(float);
+
+      if (rtcRoot)
+        bytes += bvhMemoryUsage(rtcRoot);
+
+      return bytes;
+    }
+
+    template <int W>
+    VKLObserver UnstructuredVolume<W>::newObserver(const char *type)
+    {
+      if (!this->ispcEquivalent) {
+        throw std::runtime_error(
+            "Trying to create an observer on an unstructured volume that was "
+            "not committed.");
+      }
+
+      const std::string t(type);
+      if (t == "MemoryUsage") {
+        return (VKLObserver) new MemoryUsageObserver(*this, getMemoryUsage());
+      } else {
+        return Volume<W>::newObserver(type);
+      }
+    }
+
     VKL_REGISTER_VOLUME(UnstructuredVolume<VKL_TARGET_WIDTH>,
                         CONCAT1(internal_unstructured_, VKL_TARGET_WIDTH))
 
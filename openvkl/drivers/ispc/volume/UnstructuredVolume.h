@@ -23,14 +23,19 @@ namespace openvkl {
 
     struct LeafNode : public Node
     {
-      // 18 + 8 + 4 * 6 bytes = 50
+      // 18 + 4 * 6 + 8 + 8 bytes = 58, followed by numCells cell IDs
       box3fa bounds;
-      uint64_t cellID;
-
-      LeafNode(unsigned id, const box3fa &bounds, const range1f &range)
-          : cellID(id), bounds(bounds)
+      uint64_t numCells;
+      const uint64_t *cellIDs;
+
+      LeafNode(const box3fa &bounds,
+               const range1f &range,
+               float minCellLength,
+               uint64_t numCells,
+               const uint64_t *cellIDs)
+          : bounds(bounds), numCells(numCells), cellIDs(cellIDs)
       {
-        nominalLength = -reduce_min(bounds.upper - bounds.lower);
+        nominalLength = -minCellLength;
         valueRange    = range;
       }
 
@@ -39,13 +44,32 @@ namespace openvkl {
                           size_t numPrims,
                           void *userPtr)
       {
-        assert(numPrims == 1);
+        assert(numPrims > 0);
+
+        // cell IDs are stored directly after the leaf in the same allocation
+        void *ptr = rtcThreadLocalAlloc(
+            alloc, sizeof(LeafNode) + numPrims * sizeof(uint64_t), 16);
+
+        uint64_t *cellIDs = (uint64_t *)((char *)ptr + sizeof(LeafNode));
+
+        box3fa bounds(empty);
+        range1f range(empty);
+        float minCellLength = inf;
 
-        auto id    = (uint64_t(prims->geomID) << 32) | prims->primID;
-        auto range = ((range1f *)userPtr)[id];
+        for (size_t i = 0; i < numPrims; i++) {
+          const box3fa &primBounds = *(const box3fa *)&prims[i];
 
-        void *ptr = rtcThreadLocalAlloc(alloc, sizeof(LeafNode), 16);
-        return (void *)new (ptr) LeafNode(id, *(const box3fa *)prims, range);
+          auto id    = (uint64_t(prims[i].geomID) << 32) | prims[i].primID;
+          cellIDs[i] = id;
+
+          bounds.extend(primBounds);
+          range.extend(((range1f *)userPtr)[id]);
+          minCellLength = std::min(
+              minCellLength, reduce_min(primBounds.upper - primBounds.lower));
+        }
+
+        return (void *)new (ptr)
+            LeafNode(bounds, range, minCellLength, numPrims, cellIDs);
       }
     };
 
@@ -104,6 +128,11 @@ namespace openvkl {
 
       void commit() override;
 
+      size_t getIntervalIteratorSizeV() const override
+      {
+        return sizeof(UnstructuredIterator<W>);
+      }
+
       void initIntervalIteratorV(
           const vintn<W> &valid,
           vVKLIntervalIteratorN<W> &iterator,
@@ -127,10 +156,18 @@ namespace openvkl {
 
       box3f getBoundingBox() const override;
 
+      box3f getActiveBoundingBox() const override;
+
       range1f getValueRange() const override;
 
       box4f getCellBBox(size_t id);
 
+      VKLObserver newObserver(const char *type) override;
+
+      // bytes of internal storage (BVH and derived per-cell / per-vertex
+      // data); does not include shared application buffers
+      size_t getMemoryUsage() const;
+
       const Node *getNodeRoot() const
       {
         return rtcRoot;
@@ -139,6 +176,8 @@ namespace openvkl {
      private:
       void buildBvhAndCalculateBounds();
 
+      RTCBuildQuality getBvhBuildQuality() const;
+
       // Read 32/64-bit integer value from given array
       uint64_t readInteger(const void *array, bool is32Bit, uint64_t id) const;
 
@@ -146,6 +185,11 @@ namespace openvkl {
       uint64_t getCellOffset(uint64_t id) const;
       uint64_t getVertexId(uint64_t id) const;
 
+      // Read a vertex position, dequantizing if quantization is enabled
+      vec3f getVertex(uint64_t vertexId) const;
+
+      void quantizeVertexPositions();
+
       void calculateCellNormals(const uint64_t cellId,
                                 const uint32_t faces[6][3],
                                 const uint32_t facesCount);
@@ -159,6 +203,7 @@ namespace openvkl {
      protected:
       uint64_t nCells{0};
       box3f bounds{empty};
+      box3f activeBounds{empty};
       range1f valueRange{empty};
 
       Data *vertexPosition{nullptr};
@@ -175,11 +220,20 @@ namespace openvkl {
       bool indexPrefixed{false};
       bool hexIterative{false};
 
+      std::string bvhBuildQuality{"medium"};
+      int maxLeafSize{1};
+
+      // 16-bit vertex positions relative to a global frame, if enabled;
+      // either quantizedVertices or the 'vertex.position' array
+      const uint16_t *quantizedPositions{nullptr};
+      std::vector<uint16_t> quantizedVertices;
+      vec3f quantizationOrigin{0.f};
+      vec3f quantizationScale{1.f};
+
       std::vector<vec3f> faceNormals;
       std::vector<float> iterativeTolerance;
 
       RTCBVH rtcBVH{0};
-      RTCDevice rtcDevice{0};
       Node *rtcRoot{nullptr};
     };
 
@@ -246,6 +300,12 @@ namespace openvkl {
       return bounds;
     }
 
+    template <int W>
+    inline box3f UnstructuredVolume<W>::getActiveBoundingBox() const
+    {
+      return activeBounds;
+    }
+
     template <int W>
     inline range1f UnstructuredVolume<W>::getValueRange() const
     {
@@ -275,5 +335,16 @@ namespace openvkl {
       return readInteger(index->data, index32Bit, id);
     }
 
+    template <int W>
+    inline vec3f UnstructuredVolume<W>::getVertex(uint64_t vertexId) const
+    {
+      if (!quantizedPositions)
+        return ((const vec3f *)(vertexPosition->data))[vertexId];
+
+      const uint16_t *q = quantizedPositions + 3 * vertexId;
+      return quantizationOrigin +
+             quantizationScale * vec3f(float(q[0]), float(q[1]), float(q[2]));
+    }
+
   }  // namespace ispc_driver
 }  // namespace openvkl
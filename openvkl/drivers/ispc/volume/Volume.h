@@ -77,6 +77,23 @@ namespace openvkl {
                                     vVKLIntervalN<W> &interval,
                                     vintn<W> &result);
 
+      // Take a checkpoint of a scalar interval iterator, and initialize an
+      // iterator so that it continues from a checkpoint. The default
+      // implementations work on the varying iterator that the default
+      // initIntervalIteratorU() creates; volumes that override it must
+      // override these, too.
+      virtual void getIntervalIteratorCheckpointU(
+          const vVKLIntervalIteratorN<1> &iterator,
+          VKLIntervalIteratorCheckpoint &checkpoint) const;
+
+      virtual void resumeIntervalIteratorU(
+          vVKLIntervalIteratorN<1> &iterator,
+          const vvec3fn<1> &origin,
+          const vvec3fn<1> &direction,
+          const vrange1fn<1> &tRange,
+          const VKLIntervalIteratorCheckpoint &checkpoint,
+          const ValueSelector<W> *valueSelector);
+
       // Initialize a new hit iterator for the given input ray(s) (specified by
       // origin, direction and tRange) and optional valueSelector indicating
       // volume sample values of interest. If no valueSelector is provided, or
@@ -96,6 +113,24 @@ namespace openvkl {
                                     const vrange1fn<W> &tRange,
                                     const ValueSelector<W> *valueSelector);
 
+      // Hit iterators on time-varying volumes, for the given time in [0, 1].
+      // Volumes that do not vary over time need not override these; the
+      // default implementations ignore time.
+      virtual void initHitIteratorTimeU(vVKLHitIteratorN<1> &iterator,
+                                        const vvec3fn<1> &origin,
+                                        const vvec3fn<1> &direction,
+                                        const vrange1fn<1> &tRange,
+                                        float time,
+                                        const ValueSelector<W> *valueSelector);
+
+      virtual void initHitIteratorTimeV(const vintn<W> &valid,
+                                        vVKLHitIteratorN<W> &iterator,
+                                        const vvec3fn<W> &origin,
+                                        const vvec3fn<W> &direction,
+                                        const vrange1fn<W> &tRange,
+                                        const vfloatn<W> &times,
+                                        const ValueSelector<W> *valueSelector);
+
       // Iterate once for the given iterator and return the next hit (if any)
       // satisfying the iterator's valueSelector in hit. Result (0 or 1)
       // indicates if a new hit was found.
@@ -108,6 +143,15 @@ namespace openvkl {
                                vVKLHitN<W> &hit,
                                vintn<W> &result);
 
+      // The number of bytes of internal iterator state used by the iterators
+      // above. Scalar iterators default to the varying sizes, as the default
+      // scalar implementations run the varying iterators. Volumes that
+      // implement their own iterators must override these accordingly.
+      virtual size_t getIntervalIteratorSizeU() const;
+      virtual size_t getIntervalIteratorSizeV() const;
+      virtual size_t getHitIteratorSizeU() const;
+      virtual size_t getHitIteratorSizeV() const;
+
       virtual ValueSelector<W> *newValueSelector();
 
       // volumes can optionally define a scalar sampling method; if not
@@ -119,12 +163,49 @@ namespace openvkl {
                                   const vvec3fn<W> &objectCoordinates,
                                   vfloatn<W> &samples) const = 0;
 
+      // Sampling time-varying volumes, for the given time in [0, 1]. Volumes
+      // that do not vary over time need not override these; the default
+      // implementations ignore time.
+      virtual void computeSampleTime(const vvec3fn<1> &objectCoordinates,
+                                     float time,
+                                     vfloatn<1> &samples) const;
+
+      virtual void computeSampleTimeV(const vintn<W> &valid,
+                                      const vvec3fn<W> &objectCoordinates,
+                                      const vfloatn<W> &times,
+                                      vfloatn<W> &samples) const;
+
+      // Sampling with a level of detail, given as the base-2 logarithm of
+      // the sample footprint. Volumes without level of detail need not
+      // override these; the default implementations ignore lod.
+      virtual void computeSampleLod(const vvec3fn<1> &objectCoordinates,
+                                    float lod,
+                                    vfloatn<1> &samples) const;
+
+      virtual void computeSampleLodV(const vintn<W> &valid,
+                                     const vvec3fn<W> &objectCoordinates,
+                                     const vfloatn<W> &lods,
+                                     vfloatn<W> &samples) const;
+
+      // Sampling numSamples points along a ray, at t0 + i * dt. The default
+      // implementation samples packets of W points with computeSampleV().
+      virtual void computeSampleRay(const vvec3fn<1> &origin,
+                                    const vvec3fn<1> &direction,
+                                    float t0,
+                                    float dt,
+                                    unsigned int numSamples,
+                                    float *samples) const;
+
       virtual void computeGradientV(const vintn<W> &valid,
                                     const vvec3fn<W> &objectCoordinates,
                                     vvec3fn<W> &gradients) const;
 
       virtual box3f getBoundingBox() const = 0;
 
+      // The bounds of the parts of the volume with non-zero values; iterators
+      // clip rays to this box. Defaults to the full bounding box.
+      virtual box3f getActiveBoundingBox() const;
+
       virtual range1f getValueRange() const = 0;
 
       void *getISPCEquivalent() const;
@@ -146,6 +227,30 @@ namespace openvkl {
       return createInstanceHelper<Volume<W>, VKL_VOLUME>(type);
     }
 
+    template <int W>
+    inline size_t Volume<W>::getIntervalIteratorSizeU() const
+    {
+      return getIntervalIteratorSizeV();
+    }
+
+    template <int W>
+    inline size_t Volume<W>::getIntervalIteratorSizeV() const
+    {
+      return sizeof(DefaultIterator<W>);
+    }
+
+    template <int W>
+    inline size_t Volume<W>::getHitIteratorSizeU() const
+    {
+      return getHitIteratorSizeV();
+    }
+
+    template <int W>
+    inline size_t Volume<W>::getHitIteratorSizeV() const
+    {
+      return sizeof(DefaultIterator<W>);
+    }
+
     template <int W>
     inline void Volume<W>::initIntervalIteratorU(
         vVKLIntervalIteratorN<1> &iterator,
@@ -205,6 +310,7 @@ namespace openvkl {
       interval.valueRange.lower[0] = intervalW.valueRange.lower[0];
       interval.valueRange.upper[0] = intervalW.valueRange.upper[0];
       interval.nominalDeltaT[0]    = intervalW.nominalDeltaT[0];
+      interval.majorant[0]         = intervalW.majorant[0];
 
       result[0] = resultW[0];
     }
@@ -224,6 +330,37 @@ namespace openvkl {
           *reinterpret_cast<const vVKLIntervalN<W> *>(i->getCurrentInterval());
     }
 
+    template <int W>
+    inline void Volume<W>::getIntervalIteratorCheckpointU(
+        const vVKLIntervalIteratorN<1> &iterator,
+        VKLIntervalIteratorCheckpoint &checkpoint) const
+    {
+      vVKLIntervalIteratorN<W> *iteratorW =
+          static_cast<vVKLIntervalIteratorN<W> *>(
+              const_cast<vVKLIntervalIteratorN<1> &>(iterator));
+
+      fromVKLIntervalIterator<IteratorV<W>>(iteratorW)->getCheckpoint(
+          0, checkpoint);
+    }
+
+    template <int W>
+    inline void Volume<W>::resumeIntervalIteratorU(
+        vVKLIntervalIteratorN<1> &iterator,
+        const vvec3fn<1> &origin,
+        const vvec3fn<1> &direction,
+        const vrange1fn<1> &tRange,
+        const VKLIntervalIteratorCheckpoint &checkpoint,
+        const ValueSelector<W> *valueSelector)
+    {
+      initIntervalIteratorU(iterator, origin, direction, tRange, valueSelector);
+
+      vVKLIntervalIteratorN<W> *iteratorW =
+          static_cast<vVKLIntervalIteratorN<W> *>(iterator);
+
+      fromVKLIntervalIterator<IteratorV<W>>(iteratorW)->resumeFromCheckpoint(
+          0, checkpoint);
+    }
+
     template <int W>
     inline void Volume<W>::initHitIteratorU(
         vVKLHitIteratorN<1> &iterator,
@@ -260,6 +397,52 @@ namespace openvkl {
           iterator, valid, this, origin, direction, tRange, valueSelector);
     }
 
+    template <int W>
+    inline void Volume<W>::initHitIteratorTimeU(
+        vVKLHitIteratorN<1> &iterator,
+        const vvec3fn<1> &origin,
+        const vvec3fn<1> &direction,
+        const vrange1fn<1> &tRange,
+        float time,
+        const ValueSelector<W> *valueSelector)
+    {
+      vintn<W> validW;
+      vfloatn<W> timesW;
+      for (int i = 0; i < W; i++) {
+        validW[i] = i == 0 ? -1 : 0;
+        timesW[i] = time;
+      }
+
+      vvec3fn<W> originW    = static_cast<vvec3fn<W>>(origin);
+      vvec3fn<W> directionW = static_cast<vvec3fn<W>>(direction);
+      vrange1fn<W> tRangeW  = static_cast<vrange1fn<W>>(tRange);
+
+      vVKLHitIteratorN<W> *iteratorW =
+          static_cast<vVKLHitIteratorN<W> *>(iterator);
+
+      initHitIteratorTimeV(validW,
+                           *iteratorW,
+                           originW,
+                           directionW,
+                           tRangeW,
+                           timesW,
+                           valueSelector);
+    }
+
+    template <int W>
+    inline void Volume<W>::initHitIteratorTimeV(
+        const vintn<W> &valid,
+        vVKLHitIteratorN<W> &iterator,
+        const vvec3fn<W> &origin,
+        const vvec3fn<W> &direction,
+        const vrange1fn<W> &tRange,
+        const vfloatn<W> &times,
+        const ValueSelector<W> *valueSelector)
+    {
+      initHitIteratorV(
+          valid, iterator, origin, direction, tRange, valueSelector);
+    }
+
     template <int W>
     inline void Volume<W>::iterateHitU(vVKLHitIteratorN<1> &iterator,
                                        vVKLHitN<1> &hit,
@@ -325,6 +508,79 @@ namespace openvkl {
       sample[0] = samplesW[0];
     }
 
+    template <int W>
+    inline void Volume<W>::computeSampleTime(
+        const vvec3fn<1> &objectCoordinates,
+        float time,
+        vfloatn<1> &sample) const
+    {
+      computeSample(objectCoordinates, sample);
+    }
+
+    template <int W>
+    inline void Volume<W>::computeSampleTimeV(
+        const vintn<W> &valid,
+        const vvec3fn<W> &objectCoordinates,
+        const vfloatn<W> &times,
+        vfloatn<W> &samples) const
+    {
+      computeSampleV(valid, objectCoordinates, samples);
+    }
+
+    template <int W>
+    inline void Volume<W>::computeSampleLod(
+        const vvec3fn<1> &objectCoordinates,
+        float lod,
+        vfloatn<1> &sample) const
+    {
+      computeSample(objectCoordinates, sample);
+    }
+
+    template <int W>
+    inline void Volume<W>::computeSampleLodV(
+        const vintn<W> &valid,
+        const vvec3fn<W> &objectCoordinates,
+        const vfloatn<W> &lods,
+        vfloatn<W> &samples) const
+    {
+      computeSampleV(valid, objectCoordinates, samples);
+    }
+
+    template <int W>
+    inline void Volume<W>::computeSampleRay(const vvec3fn<1> &origin,
+                                            const vvec3fn<1> &direction,
+                                            float t0,
+                                            float dt,
+                                            unsigned int numSamples,
+                                            float *samples) const
+    {
+      for (unsigned int i = 0; i < numSamples; i += W) {
+        vintn<W> validW;
+        vvec3fn<W> objectCoordinatesW;
+
+        for (int j = 0; j < W; j++) {
+          const float t = t0 + (i + j) * dt;
+
+          validW[j]               = i + j < numSamples ? -1 : 0;
+          objectCoordinatesW.x[j] = origin.x[0] + t * direction.x[0];
+          objectCoordinatesW.y[j] = origin.y[0] + t * direction.y[0];
+          objectCoordinatesW.z[j] = origin.z[0] + t * direction.z[0];
+        }
+
+        vfloatn<W> samplesW;
+        computeSampleV(validW, objectCoordinatesW, samplesW);
+
+        for (int j = 0; j < W && i + j < numSamples; j++)
+          samples[i + j] = samplesW[j];
+      }
+    }
+
+    template <int W>
+    inline box3f Volume<W>::getActiveBoundingBox() const
+    {
+      return getBoundingBox();
+    }
+
     template <int W>
     inline void Volume<W>::computeGradientV(const vintn<W> &valid,
                                             const vvec3fn<W> &objectCoordinates,
@@ -5,6 +5,7 @@
 
 #include "openvkl/ispc_cpp_interop.h"
 #include "openvkl/vdb.h"
+#include "openvkl_vdb/VdbTopologies.h"  // This file is generated by cmake.
 
 #if defined(ISPC)
 
@@ -28,12 +29,86 @@ struct VdbLevel
   // Voxels for node 0, node 1, node 2, ...
   vkl_uint64 *voxels;
 
-  // For each voxel, the original leaf index.
-  // Note: These are only valid for leaf and tile voxels.
+  // Auxiliary data is only stored for active (non-empty) voxels.
+  // activeMask has one bit per voxel, which is set if the voxel is active.
+  // activePrefix holds the number of active voxels in all previous mask
+  // words, and one additional entry with the total.
+  // Use VdbGrid_activeIndex() to find the index of a voxel's auxiliary data.
+  vkl_uint64 *activeMask;
+  vkl_uint64 *activePrefix;
+
+  // For each active voxel, the range of values contained within, as
+  // conservatively rounded half floats (lower, upper).
+  vkl_uint16 *valueRange;
+
+  // For each active voxel, the mean of the values contained within. Empty
+  // voxels count as 0. Sampling returns these when it stops above the leaves.
+  float *mean;
+
+  // For each active voxel, the original leaf index.
+  // Note: These are only valid for leaf and tile voxels, and only read
+  //       once a LeafNodeAccess observer is created.
   vkl_uint64 *leafIndex;
+};
+
+/*
+ * Leaves in the temporally structured (VKL_VDB_FORMAT_DENSE) and temporally
+ * unstructured (VKL_VDB_FORMAT_TUV) formats point to one of these instead of
+ * pointing to their data directly.
+ */
+struct VdbTemporalLeaf
+{
+  // DENSE: numTimesteps values per voxel, stored contiguously.
+  // TUV: the values of voxel v are in the range [indices[v], indices[v+1]).
+  const float *values;
 
-  // For each voxel, the range of values contained within.
-  range1f *valueRange;
+  // TUV only: one time per value, ascending for each voxel.
+  const float *times;
+
+  // TUV only: vklVdbLevelNumVoxels(level)+1 entries.
+  const vkl_uint32 *indices;
+
+  // DENSE only.
+  vkl_uint32 numTimesteps;
+};
+
+/*
+ * Requests for paged leaves, in the order in which the sampler made them.
+ * Samplers reserve a slot by incrementing numRequests, and then write the
+ * leaf index to that slot. Each leaf is in the queue at most once (see
+ * VdbPagedLeaf::requested), so one slot per paged leaf is enough.
+ */
+struct VdbPagedLeafRequests
+{
+  vkl_uint64 *slots;
+  vkl_uint64 numSlots;
+  vkl_uint64 numRequests;
+};
+
+/*
+ * Paged leaves are CONSTANT leaves that are loaded on demand (see
+ * VdbLeafCache). Their voxels point to one of these.
+ * The flags are shared with the cache thread, and only modified atomically.
+ */
+struct VdbPagedLeaf
+{
+  // The leaf data if the leaf is resident, NULL otherwise. Only written by
+  // the cache.
+  const float *data;
+
+  // The queue this leaf is requested through, and its index in that queue.
+  VdbPagedLeafRequests *requests;
+  vkl_uint64 index;
+
+  // Set by the sampler when the leaf is accessed (resident leaves) or
+  // needed (other leaves). Cleared by the cache.
+  vkl_uint32 accessed;
+  vkl_uint32 requested;
+
+  // Sampled while the leaf is not resident.
+  float fallback;
+
+  vkl_uint32 padding[3];
 };
 
 /*
@@ -50,14 +125,22 @@ struct VdbGrid
   float indexToObject[12];    // Row-major transformation matrix, 3x4,
                               // rotation-shear-scale | translation
   vkl_uint64 totalNumLeaves;  // The total number of leaf nodes in this tree.
-  vkl_uint64
-      numLeaves[VKL_VDB_NUM_LEVELS];  // The number of leaf nodes per level.
-  vkl_uint64 maxVoxelOffset;  // Used to select 64bit or 32bit traversal. TODO:
-                              // Use this in VDBSampler.ispc
+  // The number of leaf nodes per level.
+  vkl_uint64 numLeaves[VKL_VDB_MAX_NUM_LEVELS];
+  vkl_uint64 maxVoxelOffset;  // The largest voxel offset on any level. Used
+                              // to select 64bit or 32bit traversal.
   vec3i rootOrigin;           // In index space.
-  vkl_uint32
-      *usageBuffer;  // Nonzero if the given input leaf has been accessed.
-  VdbLevel levels[VKL_VDB_NUM_LEVELS - 1];
+  // Nonzero if the given input leaf has been accessed. This is published
+  // with a release store while other threads may sample, so the sampler
+  // loads the pointer once and writes through it.
+  vkl_uint32 *usageBuffer;
+  VdbTemporalLeaf *temporalLeaves;  // Headers for DENSE and TUV leaves.
+  vkl_uint64 numTemporalLeaves;
+  VdbPagedLeaf *pagedLeaves;  // Headers for leaves loaded on demand.
+  vkl_uint64 numPagedLeaves;
+  // Only the first (number of levels - 1) entries are used, depending on the
+  // topology.
+  VdbLevel levels[VKL_VDB_MAX_NUM_LEVELS - 1];
 };
 
 /*
@@ -75,6 +158,19 @@ struct VdbGrid
     r.z = M[6] * p.x + M[7] * p.y + M[8] * p.z;               \
     return r;                                                 \
   }                                                           \
+  /* Multiply with the transposed linear part. For            \
+   * M = objectToIndex, this maps index space gradients       \
+   * to object space. */                                      \
+  inline univary vec3f xfmVectorTransposed(                   \
+      const VKL_INTEROP_UNIFORM float *VKL_INTEROP_UNIFORM M, \
+      const univary vec3f &p)                                 \
+  {                                                           \
+    univary vec3f r;                                          \
+    r.x = M[0] * p.x + M[3] * p.y + M[6] * p.z;               \
+    r.y = M[1] * p.x + M[4] * p.y + M[7] * p.z;               \
+    r.z = M[2] * p.x + M[5] * p.y + M[8] * p.z;               \
+    return r;                                                 \
+  }                                                           \
   inline univary vec3f xfmPoint(                              \
       const VKL_INTEROP_UNIFORM float *VKL_INTEROP_UNIFORM M, \
       const univary vec3f &p)                                 \
@@ -89,6 +185,137 @@ struct VdbGrid
 __vkl_interop_univary(__vkl_vdb_xfm_functions)
 #undef __vkl_vdb_xfm_functions
 
+#if defined(ISPC)
+
+/*
+ * Code that depends on the topology is compiled once per topology (see
+ * VdbTopology.ispc.in). Use this to give exported and external symbols in
+ * that code a unique name.
+ */
+#define __vkl_vdb_concat2(A, B) A##B
+#define __vkl_vdb_concat(A, B) __vkl_vdb_concat2(A, B)
+#define VKL_VDB_UNIQUE(name) \
+  __vkl_vdb_concat(name, __vkl_vdb_concat(_t, VKL_VDB_TOPOLOGY))
+
+/*
+ * Map a voxel offset on the given level to the index of its auxiliary
+ * data. The voxel must be active.
+ */
+#define __vkl_vdb_active_functions(univary)                                   \
+  inline univary vkl_uint64 VdbGrid_activeIndex(                              \
+      const VdbGrid *uniform grid,                                            \
+      uniform vkl_uint32 level,                                               \
+      univary vkl_uint64 voxelOffset)                                         \
+  {                                                                           \
+    const uniform VdbLevel &l       = grid->levels[level];                    \
+    const univary vkl_uint64 word   = voxelOffset >> 6;                       \
+    const univary vkl_uint64 below  = (((univary vkl_uint64)1)                \
+                                      << (voxelOffset & 63)) - 1;              \
+    return l.activePrefix[word] +                                             \
+           popcnt((univary int64)(l.activeMask[word] & below));               \
+  }                                                                           \
+                                                                              \
+  inline univary range1f VdbGrid_getValueRange(                               \
+      const VdbGrid *uniform grid,                                            \
+      uniform vkl_uint32 level,                                               \
+      univary vkl_uint64 voxelOffset)                                         \
+  {                                                                           \
+    const univary vkl_uint64 idx =                                            \
+        VdbGrid_activeIndex(grid, level, voxelOffset);                        \
+    const vkl_uint16 *uniform r = grid->levels[level].valueRange;             \
+    univary range1f range;                                                    \
+    range.lower = half_to_float(r[2 * idx]);                                  \
+    range.upper = half_to_float(r[2 * idx + 1]);                              \
+    return range;                                                             \
+  }                                                                           \
+                                                                              \
+  inline univary float VdbGrid_getMean(const VdbGrid *uniform grid,           \
+                                       uniform vkl_uint32 level,              \
+                                       univary vkl_uint64 voxelOffset)        \
+  {                                                                           \
+    return grid->levels[level]                                                \
+        .mean[VdbGrid_activeIndex(grid, level, voxelOffset)];                 \
+  }
+
+__vkl_interop_univary(__vkl_vdb_active_functions)
+#undef __vkl_vdb_active_functions
+
+/*
+ * Flag a paged leaf as accessed, or request it from the cache. Flags are
+ * read before they are set so that samples do not write to shared cache
+ * lines in the common case. Only the sample that sets the requested flag
+ * enqueues the leaf.
+ */
+#define __vkl_vdb_paged_leaf_functions(univary)                               \
+  inline void VdbPagedLeaf_markAccessed(uniform VdbPagedLeaf *univary leaf)   \
+  {                                                                           \
+    if (!leaf->accessed)                                                      \
+      atomic_swap_global(&leaf->accessed, (univary vkl_uint32)1);             \
+  }                                                                           \
+                                                                              \
+  inline void VdbPagedLeaf_request(uniform VdbPagedLeaf *univary leaf)        \
+  {                                                                           \
+    if (leaf->requested ||                                                    \
+        atomic_swap_global(&leaf->requested, (univary vkl_uint32)1))          \
+      return;                                                                 \
+                                                                              \
+    uniform VdbPagedLeafRequests *univary requests = leaf->requests;          \
+    const univary vkl_uint64 slot =                                           \
+        atomic_add_global(&requests->numRequests, (univary vkl_uint64)1);     \
+    atomic_swap_global(requests->slots + (slot % requests->numSlots),         \
+                       leaf->index);                                          \
+  }
+
+__vkl_interop_univary(__vkl_vdb_paged_leaf_functions)
+#undef __vkl_vdb_paged_leaf_functions
+
+/*
+ * Interpolate the value of the given voxel in a DENSE or TUV leaf at the
+ * given time. Time is clamped to [0, 1], and TUV voxels hold their first and
+ * last values outside of their time range.
+ */
+inline varying float VdbGrid_sampleTemporalVoxel(
+    const uniform VdbTemporalLeaf *varying leaf,
+    varying VKLVdbLeafFormat format,
+    varying vkl_uint32 voxelIdx,
+    varying float time)
+{
+  const float t                  = clamp(time, 0.f, 1.f);
+  const uniform float *varying v = leaf->values;
+
+  if (format == VKL_VDB_FORMAT_DENSE) {
+    const vkl_uint32 numTimesteps = leaf->numTimesteps;
+    v += voxelIdx * numTimesteps;
+    if (numTimesteps < 2)
+      return v[0];
+    const float ft      = t * (numTimesteps - 1);
+    const vkl_uint32 t0 = min((vkl_uint32)ft, numTimesteps - 2);
+    return lerp(ft - t0, v[t0], v[t0 + 1]);
+  }
+
+  const uniform float *varying times = leaf->times;
+  const vkl_uint32 begin             = leaf->indices[voxelIdx];
+  const vkl_uint32 end               = leaf->indices[voxelIdx + 1];
+  if (t <= times[begin])
+    return v[begin];
+  if (t >= times[end - 1])
+    return v[end - 1];
+
+  // Find the interval [times[lo], times[hi]] that contains t.
+  vkl_uint32 lo = begin;
+  vkl_uint32 hi = end - 1;
+  while (hi - lo > 1) {
+    const vkl_uint32 mid = (lo + hi) >> 1;
+    if (times[mid] <= t)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return lerp((t - times[lo]) / (times[hi] - times[lo]), v[lo], v[hi]);
+}
+
+#endif  // defined(ISPC)
+
     // ==========================================================================
     // // Voxel encoding
     //
@@ -108,12 +335,15 @@ __vkl_interop_univary(__vkl_vdb_xfm_functions)
     //
     // - Tile values are stored exclusively in the high bits.
     //
-    // - Timesteps can be 00 (temporally unstructured), 01 (const), or 10
-    // (temporally structured).
+    // - The time format is a VKLVdbLeafFormat: 01 (const), 10 (temporally
+    // structured), or 11 (temporally unstructured).
     //
     // - The lower 4 bits of leaf pointers are used for timestep and type
     // information, which means that leaf data pointers must be aligned to 16
     // byte boundaries. VKLVdb will reject other pointers.
+    //
+    // - Tiles are never stored as leaf pointers, so leaf pointers with format
+    // VKL_VDB_FORMAT_TILE are free to point to paged leaves (VdbPagedLeaf).
     // ==========================================================================
     // //
 
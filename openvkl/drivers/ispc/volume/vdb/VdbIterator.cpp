@@ -4,7 +4,6 @@
 #include "VdbIterator.h"
 #include "../../common/export_util.h"
 #include "../../iterator/Iterator.h"
-#include "VdbIterator_ispc.h"
 #include "VdbVolume.h"
 
 namespace openvkl {
@@ -19,66 +18,91 @@ namespace openvkl {
                                 const vvec3fn<W> &origin,
                                 const vvec3fn<W> &direction,
                                 const vrange1fn<W> &tRange,
+                                const float *times,
                                 const ValueSelector<W> *valueSelector)
         : IteratorV<W>(valid, volume, origin, direction, tRange, valueSelector)
     {
       static bool oneTimeChecks = false;
 
       if (!oneTimeChecks) {
-        int ispcSize = CALL_ISPC(VdbIterator_sizeOf);
+        for (uint32_t t = 0; t < VKL_VDB_NUM_TOPOLOGIES; ++t) {
+          int ispcSize = getVdbTopology(t).iteratorSizeOf();
 
-        if (ispcSize > ispcStorageSize) {
-          LogMessageStream(VKL_LOG_ERROR)
-              << "VdbIterator required ISPC object size = " << ispcSize
-              << ", allocated size = " << ispcStorageSize << std::endl;
+          if (ispcSize > ispcStorageSize) {
+            LogMessageStream(VKL_LOG_ERROR)
+                << "VdbIterator required ISPC object size = " << ispcSize
+                << ", allocated size = " << ispcStorageSize << std::endl;
 
-          throw std::runtime_error("VdbIterator has insufficient ISPC storage");
+            throw std::runtime_error(
+                "VdbIterator has insufficient ISPC storage");
+          }
         }
 
         oneTimeChecks = true;
       }
 
-      CALL_ISPC(VdbIterator_Initialize,
-                static_cast<const int *>(valid),
-                &ispcStorage[0],
-                volume->getGrid(),
-                (void *)&origin,
-                (void *)&direction,
-                (void *)&tRange,
-                valueSelector ? valueSelector->getISPCEquivalent() : nullptr);
+      getTopology().iteratorInitialize(
+          static_cast<const int *>(valid),
+          &ispcStorage[0],
+          volume->getGrid(),
+          (void *)&origin,
+          (void *)&direction,
+          (void *)&tRange,
+          times,
+          valueSelector ? valueSelector->getISPCEquivalent() : nullptr);
+    }
+
+    template <int W>
+    const VdbTopology &VdbIterator<W>::getTopology() const
+    {
+      return static_cast<const VdbVolume<W> *>(this->volume)->getTopology();
     }
 
     template <int W>
     const Interval<W> *VdbIterator<W>::getCurrentInterval() const
     {
       return reinterpret_cast<const Interval<W> *>(
-          CALL_ISPC(VdbIterator_getCurrentInterval, (void *)&ispcStorage[0]));
+          getTopology().iteratorGetCurrentInterval((void *)&ispcStorage[0]));
     }
 
     template <int W>
     void VdbIterator<W>::iterateInterval(const vintn<W> &valid,
                                          vintn<W> &result)
     {
-      CALL_ISPC(VdbIterator_iterateInterval,
-                static_cast<const int *>(valid),
-                (void *)&ispcStorage[0],
-                static_cast<int *>(result));
+      getTopology().iteratorIterateInterval(static_cast<const int *>(valid),
+                                            (void *)&ispcStorage[0],
+                                            static_cast<int *>(result));
+    }
+
+    template <int W>
+    void VdbIterator<W>::getCheckpoint(
+        int lane, VKLIntervalIteratorCheckpoint &checkpoint) const
+    {
+      getTopology().iteratorGetCheckpoint(
+          (void *)&ispcStorage[0], lane, &checkpoint);
+    }
+
+    template <int W>
+    void VdbIterator<W>::resumeFromCheckpoint(
+        int lane, const VKLIntervalIteratorCheckpoint &checkpoint)
+    {
+      getTopology().iteratorResumeFromCheckpoint(
+          (void *)&ispcStorage[0], lane, (void *)&checkpoint);
     }
 
     template <int W>
     const Hit<W> *VdbIterator<W>::getCurrentHit() const
     {
       return reinterpret_cast<const Hit<W> *>(
-          CALL_ISPC(VdbIterator_getCurrentHit, (void *)&ispcStorage[0]));
+          getTopology().iteratorGetCurrentHit((void *)&ispcStorage[0]));
     }
 
     template <int W>
     void VdbIterator<W>::iterateHit(const vintn<W> &valid, vintn<W> &result)
     {
-      CALL_ISPC(VdbIterator_iterateHit,
-                static_cast<const int *>(valid),
-                (void *)&ispcStorage[0],
-                static_cast<int *>(result));
+      getTopology().iteratorIterateHit(static_cast<const int *>(valid),
+                                       (void *)&ispcStorage[0],
+                                       static_cast<int *>(result));
     }
 
     template class VdbIterator<VKL_TARGET_WIDTH>;
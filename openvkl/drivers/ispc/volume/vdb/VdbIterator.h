@@ -5,6 +5,7 @@
 
 #include "../../iterator/Iterator.h"
 #include "VdbGrid.h"
+#include "VdbTopology.h"
 
 using namespace ospcommon;
 
@@ -26,24 +27,41 @@ namespace openvkl {
       VdbIterator()  = default;
       ~VdbIterator() = default;
 
+      /*
+       * times may be null, in which case hit iterators find surfaces at
+       * time 0.
+       */
       VdbIterator(const vintn<W> &valid,
                   const VdbVolume<W> *volume,
                   const vvec3fn<W> &origin,
                   const vvec3fn<W> &direction,
                   const vrange1fn<W> &tRange,
+                  const float *times,
                   const ValueSelector<W> *valueSelector);
 
       const Interval<W> *getCurrentInterval() const override;
       void iterateInterval(const vintn<W> &valid, vintn<W> &result) override;
 
+      void getCheckpoint(
+          int lane, VKLIntervalIteratorCheckpoint &checkpoint) const override;
+      void resumeFromCheckpoint(
+          int lane, const VKLIntervalIteratorCheckpoint &checkpoint) override;
+
       const Hit<W> *getCurrentHit() const override;
       void iterateHit(const vintn<W> &valid, vintn<W> &result) override;
 
-      // Required size of ISPC-side object for width W.
+      // Required size of ISPC-side object for width W. Only the node stack
+      // depends on the number of levels.
       // Use the vklVdbIteratorSize<W> tools to find out the correct size.
-      static constexpr int ispcStorageSize = 376 * W;
+      static constexpr int ispcStorageSize =
+          (188 + 4 * VKL_VDB_MAX_NUM_LEVELS) * W;
 
      protected:
+      /*
+       * The topology of the volume we iterate over.
+       */
+      const VdbTopology &getTopology() const;
+
       alignas(simd_alignment_for_width(W)) char ispcStorage[ispcStorageSize];
     };
 
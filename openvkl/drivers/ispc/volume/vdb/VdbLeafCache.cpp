@@ -0,0 +1,262 @@
+// Copyright 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "VdbLeafCache.h"
+#include <algorithm>
+#include <limits>
+#include "ospcommon/memory/malloc.h"
+
+namespace openvkl {
+  namespace ispc_driver {
+
+    // Marks request slots that the sampler has not written yet.
+    static constexpr uint64_t emptySlot = std::numeric_limits<uint64_t>::max();
+
+    /*
+     * The sampler (in ISPC) modifies paged leaf headers and the request
+     * queue with atomic operations, so we must do the same here.
+     */
+    template <class T>
+    inline std::atomic<T> &atomicRef(T &value)
+    {
+      static_assert(sizeof(std::atomic<T>) == sizeof(T),
+                    "std::atomic must not add storage");
+      return reinterpret_cast<std::atomic<T> &>(value);
+    }
+
+    VdbLeafCache::VdbLeafCache(const VdbTopology &topology,
+                               VKLVdbLeafLoader loader,
+                               void *userData,
+                               VdbPagedLeaf *pagedLeaves,
+                               std::vector<uint64_t> nodeIndices,
+                               std::vector<uint32_t> levels,
+                               size_t capacity,
+                               bool waitForLoads)
+        : loader(loader),
+          userData(userData),
+          pagedLeaves(pagedLeaves),
+          nodeIndices(std::move(nodeIndices)),
+          levels(std::move(levels)),
+          failed(this->nodeIndices.size(), false),
+          capacity(std::max<size_t>(capacity, 1)),
+          waitForLoads(waitForLoads),
+          requestSlots(this->nodeIndices.size(), emptySlot)
+    {
+      for (uint32_t level : this->levels) {
+        bufferSize =
+            std::max<size_t>(bufferSize, topology.levelNumVoxels(level));
+      }
+
+      requests.slots       = requestSlots.data();
+      requests.numSlots    = requestSlots.size();
+      requests.numRequests = 0;
+      bytesAllocated       = requestSlots.size() * sizeof(uint64_t);
+
+      for (uint64_t i = 0; i < this->nodeIndices.size(); ++i) {
+        pagedLeaves[i].requests = &requests;
+        pagedLeaves[i].index    = i;
+      }
+
+      numReaders[0] = 0;
+      numReaders[1] = 0;
+
+      thread = std::thread([this]() { run(); });
+    }
+
+    VdbLeafCache::~VdbLeafCache()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      condition.notify_all();
+      done.notify_all();
+      thread.join();
+
+      for (float *buffer : buffers)
+        ospcommon::memory::alignedFree(buffer);
+    }
+
+    uint64_t VdbLeafCache::enterRead()
+    {
+      // If the epoch changed while we registered, the cache thread may
+      // already be waiting on the other slot, so register again.
+      while (true) {
+        const uint64_t e = epoch.load();
+        ++numReaders[e & 1];
+        if (epoch.load() == e)
+          return e;
+        --numReaders[e & 1];
+      }
+    }
+
+    void VdbLeafCache::leaveRead(uint64_t e)
+    {
+      --numReaders[e & 1];
+      if (waitForLoads)
+        flush();
+      else
+        wake();
+    }
+
+    void VdbLeafCache::wake()
+    {
+      if (atomicRef(requests.numRequests).load() == requestsDone.load())
+        return;
+
+      if (!wakeRequested.exchange(true)) {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+        }
+        condition.notify_one();
+      }
+    }
+
+    void VdbLeafCache::flush()
+    {
+      const uint64_t target = atomicRef(requests.numRequests).load();
+      if (requestsDone.load() >= target)
+        return;
+
+      std::unique_lock<std::mutex> lock(mutex);
+      wakeRequested = true;
+      condition.notify_one();
+      done.wait(lock,
+                [this, target]() { return stop || requestsDone >= target; });
+    }
+
+    void VdbLeafCache::run()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        condition.wait(lock, [this]() { return stop || wakeRequested; });
+        if (stop)
+          break;
+
+        // Requests made from here on will wake us up again.
+        wakeRequested = false;
+        lock.unlock();
+        update();
+        lock.lock();
+
+        requestsDone = requestsHead;
+        done.notify_all();
+      }
+    }
+
+    void VdbLeafCache::update()
+    {
+      const uint64_t numRequests = atomicRef(requests.numRequests).load();
+      std::vector<uint64_t> pending;
+      for (; requestsHead < numRequests; ++requestsHead) {
+        // Samplers reserve a slot before they write to it.
+        std::atomic<uint64_t> &slot =
+            atomicRef(requestSlots[requestsHead % requestSlots.size()]);
+        uint64_t i = slot.load();
+        while (i == emptySlot) {
+          std::this_thread::yield();
+          i = slot.load();
+        }
+        slot.store(emptySlot);
+
+        // Failed leaves stay requested, so that they are not enqueued again.
+        if (failed[i])
+          continue;
+
+        if (atomicRef(pagedLeaves[i].data).load())
+          atomicRef(pagedLeaves[i].requested).store(0);
+        else
+          pending.push_back(i);
+      }
+
+      if (pending.empty())
+        return;
+
+      // Make room for the requests that we cannot serve in this round.
+      const size_t numAvailable =
+          freeBuffers.size() + (capacity - buffers.size());
+      if (pending.size() > numAvailable) {
+        evict(pending.size() - numAvailable);
+        synchronize();
+      }
+
+      for (uint64_t i : pending) {
+        VdbPagedLeaf &leaf = pagedLeaves[i];
+
+        float *buffer = acquireBuffer();
+        if (buffer && !loader(userData, nodeIndices[i], levels[i], buffer)) {
+          failed[i] = true;
+          freeBuffers.push_back(buffer);
+          continue;
+        }
+
+        // Publish the data only once it is complete. Leaves that we have no
+        // buffer for may be requested again.
+        if (buffer) {
+          atomicRef(leaf.accessed).store(1);
+          atomicRef(leaf.data).store(buffer, std::memory_order_release);
+          resident.push_back(i);
+        }
+        atomicRef(leaf.requested).store(0);
+      }
+    }
+
+    void VdbLeafCache::evict(size_t numLeaves)
+    {
+      // Every resident leaf is visited at most twice: once to clear its
+      // accessed flag, and once to evict it.
+      for (size_t n = 2 * resident.size(); n > 0 && numLeaves > 0; --n) {
+        if (clockHand >= resident.size())
+          clockHand = 0;
+
+        VdbPagedLeaf &leaf = pagedLeaves[resident[clockHand]];
+        if (atomicRef(leaf.accessed).exchange(0)) {
+          ++clockHand;
+          continue;
+        }
+
+        retiredBuffers.push_back(
+            const_cast<float *>(atomicRef(leaf.data).exchange(nullptr)));
+        resident[clockHand] = resident.back();
+        resident.pop_back();
+        --numLeaves;
+      }
+    }
+
+    void VdbLeafCache::synchronize()
+    {
+      // Readers that enter the new epoch cannot see the data we unpublished
+      // before advancing it.
+      const uint64_t e = epoch++;
+      while (numReaders[e & 1] > 0)
+        std::this_thread::yield();
+
+      freeBuffers.insert(
+          freeBuffers.end(), retiredBuffers.begin(), retiredBuffers.end());
+      retiredBuffers.clear();
+    }
+
+    float *VdbLeafCache::acquireBuffer()
+    {
+      if (!freeBuffers.empty()) {
+        float *buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+        return buffer;
+      }
+
+      if (buffers.size() < capacity) {
+        const size_t numBytes = bufferSize * sizeof(float);
+        float *buffer         = reinterpret_cast<float *>(
+            ospcommon::memory::alignedMalloc(numBytes));
+        if (!buffer)
+          return nullptr;
+        buffers.push_back(buffer);
+        bytesAllocated += numBytes;
+        return buffer;
+      }
+
+      return nullptr;
+    }
+
+  }  // namespace ispc_driver
+}  // namespace openvkl
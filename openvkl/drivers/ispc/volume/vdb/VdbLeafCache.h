@@ -0,0 +1,160 @@
+// Copyright 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <openvkl/vdb.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "VdbGrid.h"
+#include "VdbTopology.h"
+
+namespace openvkl {
+  namespace ispc_driver {
+
+    /*
+     * A bounded cache for paged leaves (see VdbPagedLeaf).
+     *
+     * The sampler enqueues the leaves it needs (see VdbPagedLeafRequests),
+     * and a background thread loads them. The thread sleeps until a reader
+     * leaves with requests pending. Once the cache is full, leaves that have
+     * not been accessed recently are evicted (using the CLOCK approximation
+     * of LRU).
+     *
+     * Evicted buffers are reclaimed with an epoch scheme: all code that may
+     * read leaf data must hold a ReadGuard, and buffers are only reused once
+     * every guard that could have seen them is released.
+     */
+    struct VdbLeafCache
+    {
+      /*
+       * pagedLeaves has one entry per element of nodeIndices (the input
+       * node index passed to the loader) and levels.
+       * If waitForLoads is set, readers wait for their requests to be
+       * loaded when they release their guard.
+       */
+      VdbLeafCache(const VdbTopology &topology,
+                   VKLVdbLeafLoader loader,
+                   void *userData,
+                   VdbPagedLeaf *pagedLeaves,
+                   std::vector<uint64_t> nodeIndices,
+                   std::vector<uint32_t> levels,
+                   size_t capacity,
+                   bool waitForLoads);
+
+      VdbLeafCache(VdbLeafCache &&)      = delete;
+      VdbLeafCache(const VdbLeafCache &) = delete;
+      VdbLeafCache &operator=(VdbLeafCache &&) = delete;
+      VdbLeafCache &operator=(const VdbLeafCache &) = delete;
+
+      ~VdbLeafCache();
+
+      /*
+       * Hold one of these while reading paged leaf data. A null cache is
+       * allowed, and makes the guard a no-op.
+       */
+      struct ReadGuard
+      {
+        explicit ReadGuard(VdbLeafCache *cache) : cache(cache)
+        {
+          if (cache)
+            epoch = cache->enterRead();
+        }
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+        ~ReadGuard()
+        {
+          if (cache)
+            cache->leaveRead(epoch);
+        }
+
+       private:
+        VdbLeafCache *cache{nullptr};
+        uint64_t epoch{0};
+      };
+
+      /*
+       * Block until all requests made so far have been processed.
+       */
+      void flush();
+
+      /*
+       * The number of bytes allocated for leaf buffers and the request
+       * queue.
+       */
+      size_t getBytesAllocated() const
+      {
+        return bytesAllocated;
+      }
+
+     private:
+      uint64_t enterRead();
+      void leaveRead(uint64_t epoch);
+
+      /*
+       * Wake the cache thread if there are requests it has not seen.
+       */
+      void wake();
+
+      void run();
+
+      /*
+       * Load requested leaves, evicting leaves if necessary.
+       */
+      void update();
+
+      /*
+       * Evict up to the given number of leaves. Their buffers are retired.
+       */
+      void evict(size_t numLeaves);
+
+      /*
+       * Start a new epoch, and wait until no reader is left in the previous
+       * one. Retired buffers are free after this.
+       */
+      void synchronize();
+
+      float *acquireBuffer();
+
+     private:
+      VKLVdbLeafLoader loader{nullptr};
+      void *userData{nullptr};
+      VdbPagedLeaf *pagedLeaves{nullptr};
+      std::vector<uint64_t> nodeIndices;
+      std::vector<uint32_t> levels;
+      std::vector<bool> failed;
+      size_t capacity{0};
+      size_t bufferSize{0};
+      bool waitForLoads{false};
+
+      std::vector<uint64_t> requestSlots;
+      VdbPagedLeafRequests requests;
+      uint64_t requestsHead{0};
+      std::atomic<uint64_t> requestsDone{0};
+
+      std::vector<float *> buffers;
+      std::vector<float *> freeBuffers;
+      std::vector<float *> retiredBuffers;
+      std::vector<uint64_t> resident;
+      size_t clockHand{0};
+      std::atomic<size_t> bytesAllocated{0};
+
+      // Readers count themselves in the slot of the epoch they entered in.
+      std::atomic<uint64_t> epoch{0};
+      std::atomic<size_t> numReaders[2];
+
+      std::mutex mutex;
+      std::condition_variable condition;
+      std::condition_variable done;
+      std::atomic<bool> wakeRequested{false};
+      bool stop{false};
+      std::thread thread;
+    };
+
+  }  // namespace ispc_driver
+}  // namespace openvkl
@@ -0,0 +1,47 @@
+// Copyright 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "VdbTopology.h"
+#include <stdexcept>
+
+namespace openvkl {
+  namespace ispc_driver {
+
+    // Defined in the generated files VdbTopology_t<topology>.cpp.
+#define __vkl_vdb_declare_topology(T) const VdbTopology &vdbTopology_t##T();
+    __vkl_vdb_iterate_topologies(__vkl_vdb_declare_topology)
+#undef __vkl_vdb_declare_topology
+
+    const VdbTopology &getVdbTopology(uint32_t index)
+    {
+      switch (index) {
+#define __vkl_vdb_topology_case(T) \
+  case T:                          \
+    return vdbTopology_t##T();
+        __vkl_vdb_iterate_topologies(__vkl_vdb_topology_case)
+#undef __vkl_vdb_topology_case
+      default:
+        throw std::out_of_range("invalid VDB topology index");
+      }
+    }
+
+    const VdbTopology *findVdbTopology(const uint32_t *logRes,
+                                       size_t numLevels)
+    {
+      for (uint32_t i = 0; i < VKL_VDB_NUM_TOPOLOGIES; ++i) {
+        const VdbTopology &topology = getVdbTopology(i);
+        if (topology.numLevels != numLevels)
+          continue;
+
+        bool match = true;
+        for (uint32_t l = 0; l < numLevels; ++l)
+          match = match && (topology.logRes[l] == logRes[l]);
+
+        if (match)
+          return &topology;
+      }
+      return nullptr;
+    }
+
+  }  // namespace ispc_driver
+}  // namespace openvkl
@@ -0,0 +1,127 @@
+// Copyright 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "VdbGrid.h"
+
+namespace openvkl {
+  namespace ispc_driver {
+
+    /*
+     * A VDB tree topology, i.e. the resolution of nodes on each level.
+     *
+     * VDB sampling and traversal is compiled once for each topology in
+     * VdbTopologies.h. Volumes select their topology on commit, and then
+     * call into the ISPC code through these function pointers.
+     *
+     * The level helpers are the runtime equivalent of vklVdbLevelLogRes()
+     * etc. in openvkl/vdb.h, which only describe the default topology.
+     */
+    struct VdbTopology
+    {
+      uint32_t numLevels{0};
+      uint32_t logRes[VKL_VDB_MAX_NUM_LEVELS];
+
+      uint32_t levelLogRes(uint32_t level) const
+      {
+        return level < numLevels ? logRes[level] : 0;
+      }
+
+      /*
+       * The base-2 logarithm of the domain resolution of nodes on the
+       * given level. This is 0 below the leaf level.
+       */
+      uint32_t levelTotalLogRes(uint32_t level) const
+      {
+        uint32_t totalLogRes = 0;
+        for (uint32_t l = level; l < numLevels; ++l)
+          totalLogRes += logRes[l];
+        return totalLogRes;
+      }
+
+      uint32_t levelStorageRes(uint32_t level) const
+      {
+        return level < numLevels ? (1u << logRes[level]) : 0;
+      }
+
+      uint32_t levelRes(uint32_t level) const
+      {
+        return level < numLevels ? (1u << levelTotalLogRes(level)) : 0;
+      }
+
+      uint64_t levelNumVoxels(uint32_t level) const
+      {
+        return level < numLevels ? (((uint64_t)1) << (3 * logRes[level]))
+                                 : 0;
+      }
+
+      // ISPC entry points, see VdbSampler.ispc and VdbIterator.ispc.
+
+      void (*setGrid)(void *volume, const void *grid);
+
+      void (*computeSample)(const int *valid,
+                            const void *volume,
+                            const void *objectCoordinates,
+                            const void *times,
+                            const void *lods,
+                            void *samples);
+
+      void (*computeSampleUniform)(const void *volume,
+                                   const void *objectCoordinates,
+                                   const void *times,
+                                   const void *lods,
+                                   void *samples);
+
+      void (*computeGradient)(const int *valid,
+                              const void *volume,
+                              const void *objectCoordinates,
+                              void *gradients);
+
+      int (*iteratorSizeOf)();
+
+      void (*iteratorInitialize)(const int *valid,
+                                 void *iterator,
+                                 const void *grid,
+                                 void *origin,
+                                 void *direction,
+                                 void *tRange,
+                                 const void *times,
+                                 void *valueSelector);
+
+      void *(*iteratorGetCurrentInterval)(void *iterator);
+
+      void (*iteratorIterateInterval)(const int *valid,
+                                      void *iterator,
+                                      int *result);
+
+      void (*iteratorGetCheckpoint)(void *iterator, int lane, void *checkpoint);
+
+      void (*iteratorResumeFromCheckpoint)(void *iterator,
+                                           int lane,
+                                           void *checkpoint);
+
+      void *(*iteratorGetCurrentHit)(void *iterator);
+
+      void (*iteratorIterateHit)(const int *valid,
+                                 void *iterator,
+                                 int *result);
+    };
+
+    /*
+     * The topology with the given index in [0, VKL_VDB_NUM_TOPOLOGIES).
+     * Topology 0 is the default topology.
+     */
+    const VdbTopology &getVdbTopology(uint32_t index);
+
+    /*
+     * Find the topology with the given per level log resolutions (root
+     * first). Returns nullptr if this topology was not compiled in.
+     */
+    const VdbTopology *findVdbTopology(const uint32_t *logRes,
+                                       size_t numLevels);
+
+  }  // namespace ispc_driver
+}  // namespace openvkl
@@ -2,15 +2,21 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "VdbVolume.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <unordered_map>
 #include "../../common/export_util.h"
 #include "../common/logging.h"
+#include "../MemoryUsageObserver.h"
 #include "VdbLeafAccessObserver.h"
-#include "VdbSampler_ispc.h"
 #include "openvkl/vdb.h"
 #include "ospcommon/math/AffineSpace.h"
 #include "ospcommon/memory/malloc.h"
 #include "ospcommon/tasking/AsyncTask.h"
+#include "ospcommon/tasking/parallel_for.h"
 
 namespace openvkl {
   namespace ispc_driver {
@@ -56,6 +62,8 @@ namespace openvkl {
       swap(dataData, other.dataData);
       swap(grid, other.grid);
       swap(bytesAllocated, other.bytesAllocated);
+      swap(leafCache, other.leafCache);
+      swap(topology, other.topology);
     }
 
     template <int W>
@@ -69,6 +77,8 @@ namespace openvkl {
         swap(dataData, other.dataData);
         swap(grid, other.grid);
         swap(bytesAllocated, other.bytesAllocated);
+        swap(leafCache, other.leafCache);
+        swap(topology, other.topology);
       }
       return *this;
     }
@@ -82,14 +92,22 @@ namespace openvkl {
     template <int W>
     void VdbVolume<W>::cleanup()
     {
+      // The cache thread writes to the paged leaves, so stop it first.
+      leafCache.reset();
+
       if (grid) {
-        for (uint32_t l = 0; l < vklVdbNumLevels(); ++l) {
+        for (uint32_t l = 0; l + 1 < VKL_VDB_MAX_NUM_LEVELS; ++l) {
           VdbLevel &level = grid->levels[l];
           deallocate(level.voxels);
+          deallocate(level.activeMask);
+          deallocate(level.activePrefix);
           deallocate(level.valueRange);
+          deallocate(level.mean);
           deallocate(level.leafIndex);
         }
         deallocate(grid->usageBuffer);
+        deallocate(grid->temporalLeaves);
+        deallocate(grid->pagedLeaves);
         deallocate(grid);
       }
       bytesAllocated = 0;
@@ -115,182 +133,411 @@ namespace openvkl {
       throw std::runtime_error(os.str());
     }
 
+    // -------------------------------------------------------------------------
+    // Parallel building blocks for commit().
+    // -------------------------------------------------------------------------
+
+    // Parallel loops over leaves and nodes process blocks of this size.
+    constexpr uint64_t commitBlockSize = 1 << 14;
+
+    inline uint64_t numCommitBlocks(uint64_t n)
+    {
+      return (n + commitBlockSize - 1) / commitBlockSize;
+    }
+
+    /*
+     * Call body(blockIndex, begin, end) for all blocks of [0, n), in parallel.
+     */
+    template <typename Func>
+    void parallelForBlocks(uint64_t n, Func &&body)
+    {
+      tasking::parallel_for(numCommitBlocks(n), [&](uint64_t blockIndex) {
+        const uint64_t begin = blockIndex * commitBlockSize;
+        const uint64_t end   = std::min(begin + commitBlockSize, n);
+        body(blockIndex, begin, end);
+      });
+    }
+
+    /*
+     * Return select(i) for all i in [0, n) for which pred(i) is true, in
+     * order of i.
+     */
+    template <typename Pred, typename Select>
+    std::vector<uint64_t> parallelSelect(uint64_t n,
+                                         Pred &&pred,
+                                         Select &&select)
+    {
+      const uint64_t numBlocks = numCommitBlocks(n);
+      std::vector<uint64_t> blockOffset(numBlocks + 1, 0);
+      parallelForBlocks(n, [&](uint64_t b, uint64_t begin, uint64_t end) {
+        uint64_t count = 0;
+        for (uint64_t i = begin; i < end; ++i)
+          count += pred(i) ? 1 : 0;
+        blockOffset[b + 1] = count;
+      });
+
+      for (uint64_t b = 0; b < numBlocks; ++b)
+        blockOffset[b + 1] += blockOffset[b];
+
+      std::vector<uint64_t> selected(blockOffset[numBlocks]);
+      parallelForBlocks(n, [&](uint64_t b, uint64_t begin, uint64_t end) {
+        uint64_t o = blockOffset[b];
+        for (uint64_t i = begin; i < end; ++i) {
+          if (pred(i))
+            selected[o++] = select(i);
+        }
+      });
+      return selected;
+    }
+
+    /*
+     * Parallel LSD radix sort on the lowest numBits bits of the given keys.
+     * Higher bits must be zero.
+     */
+    void parallelRadixSort(std::vector<uint64_t> &keys, uint32_t numBits)
+    {
+      constexpr uint32_t digitBits  = 8;
+      constexpr uint64_t numBuckets = 1 << digitBits;
+      constexpr uint64_t digitMask  = numBuckets - 1;
+
+      const uint64_t n         = keys.size();
+      const uint64_t numBlocks = numCommitBlocks(n);
+      std::vector<uint64_t> tmp(n);
+      std::vector<uint64_t> offsets(numBlocks * numBuckets);
+
+      for (uint32_t shift = 0; shift < numBits; shift += digitBits) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        parallelForBlocks(n, [&](uint64_t b, uint64_t begin, uint64_t end) {
+          uint64_t *histogram = offsets.data() + b * numBuckets;
+          for (uint64_t i = begin; i < end; ++i)
+            ++histogram[(keys[i] >> shift) & digitMask];
+        });
+
+        // Bucket major prefix sum, so that each pass is stable.
+        uint64_t sum = 0;
+        for (uint64_t d = 0; d < numBuckets; ++d) {
+          for (uint64_t b = 0; b < numBlocks; ++b) {
+            uint64_t &o         = offsets[b * numBuckets + d];
+            const uint64_t size = o;
+            o                   = sum;
+            sum += size;
+          }
+        }
+
+        parallelForBlocks(n, [&](uint64_t b, uint64_t begin, uint64_t end) {
+          uint64_t *o = offsets.data() + b * numBuckets;
+          for (uint64_t i = begin; i < end; ++i)
+            tmp[o[(keys[i] >> shift) & digitMask]++] = keys[i];
+        });
+
+        keys.swap(tmp);
+      }
+    }
+
     /*
-     * Compute the grid bounding box and count the number of leaves per level.
+     * Remove duplicates from a sorted vector, in parallel.
      */
-    box3i computeBbox(uint64_t numLeaves,
+    void parallelUnique(std::vector<uint64_t> &keys)
+    {
+      keys = parallelSelect(
+          keys.size(),
+          [&](uint64_t i) { return i == 0 || keys[i] != keys[i - 1]; },
+          [&](uint64_t i) { return keys[i]; });
+    }
+
+    // -------------------------------------------------------------------------
+
+    /*
+     * Compute the grid bounding box.
+     */
+    box3i computeBbox(const VdbTopology &topology,
+                      uint64_t numLeaves,
                       const uint32_t *leafLevel,
                       const vec3i *leafOrigin)
     {
+      std::vector<box3i> blockBbox(numCommitBlocks(numLeaves), box3i());
+      parallelForBlocks(
+          numLeaves, [&](uint64_t b, uint64_t begin, uint64_t end) {
+            box3i &bbox = blockBbox[b];
+            for (uint64_t i = begin; i < end; ++i) {
+              bbox.extend(leafOrigin[i]);
+              bbox.extend(leafOrigin[i] +
+                          vec3ui(topology.levelRes(leafLevel[i])));
+            }
+          });
+
       box3i bbox = box3i();
-      for (size_t i = 0; i < numLeaves; ++i) {
-        bbox.extend(leafOrigin[i]);
-        bbox.extend(leafOrigin[i] + vec3ui(vklVdbLevelRes(leafLevel[i])));
-      }
+      for (const box3i &b : blockBbox)
+        bbox.extend(b);
       return bbox;
     }
 
     /*
-     * Bin leaves per level (returns indices into the input leaf array).
+     * Count the number of leaves per level, and validate leaf levels.
      */
-    std::vector<std::vector<uint64_t>> binLeavesPerLevel(
-        uint64_t numLeaves, const uint32_t *leafLevel)
+    std::vector<uint64_t> countLeavesPerLevel(const VdbTopology &topology,
+                                              uint64_t numLeaves,
+                                              const uint32_t *leafLevel)
     {
-      std::vector<size_t> numLeavesPerLevel(vklVdbNumLevels(), 0);
-      for (uint64_t i = 0; i < numLeaves; ++i) {
-        if (leafLevel[i] == 0)
-          runtimeError("there must not be any leaf nodes on level 0");
-        numLeavesPerLevel[leafLevel[i]]++;
-      }
+      const uint32_t numLevels = topology.numLevels;
+      std::vector<uint64_t> blockCounts(numCommitBlocks(numLeaves) * numLevels,
+                                        0);
+      std::atomic<bool> hasRootLeaves{false};
+      std::atomic<bool> hasInvalidLevels{false};
+
+      parallelForBlocks(
+          numLeaves, [&](uint64_t b, uint64_t begin, uint64_t end) {
+            uint64_t *counts = blockCounts.data() + b * numLevels;
+            for (uint64_t i = begin; i < end; ++i) {
+              if (leafLevel[i] == 0)
+                hasRootLeaves = true;
+              else if (leafLevel[i] >= numLevels)
+                hasInvalidLevels = true;
+              else
+                ++counts[leafLevel[i]];
+            }
+          });
 
-      // Sort leaves by level.
-      std::vector<std::vector<uint64_t>> binnedLeaves(vklVdbNumLevels());
-      ;
-      for (uint64_t l = 1; l < vklVdbNumLevels();
-           ++l)  // level 0 has no leaves!
-        binnedLeaves[l].reserve(numLeavesPerLevel[l]);
-      for (uint64_t i = 0; i < numLeaves; ++i)
-        binnedLeaves[leafLevel[i]].push_back(i);
-      return binnedLeaves;
+      if (hasRootLeaves)
+        runtimeError("there must not be any leaf nodes on level 0");
+
+      if (hasInvalidLevels)
+        runtimeError("leaf nodes must be on levels less than ", numLevels);
+
+      std::vector<uint64_t> numLeavesPerLevel(numLevels, 0);
+      for (size_t b = 0; b < blockCounts.size(); ++b)
+        numLeavesPerLevel[b % numLevels] += blockCounts[b];
+      return numLeavesPerLevel;
     }
 
     /*
      * Compute the root node origin from the bounding box.
      */
-    vec3i computeRootOrigin(const box3i &bbox)
+    vec3i computeRootOrigin(const VdbTopology &topology, const box3i &bbox)
     {
       const vec3ui bboxRes = bbox.upper - bbox.lower;
-      if (bboxRes.x > vklVdbLevelRes(0) || bboxRes.y > vklVdbLevelRes(0) ||
-          bboxRes.z > vklVdbLevelRes(0)) {
+      const uint32_t res0  = topology.levelRes(0);
+      const uint32_t res1  = topology.levelRes(1);
+      if (bboxRes.x > res0 || bboxRes.y > res0 || bboxRes.z > res0) {
         runtimeError("input leaves do not fit into a single root level node");
       }
-      return vec3i(
-          vklVdbLevelRes(1) *
-              (int)std::floor(bbox.lower.x / (float)vklVdbLevelRes(1)),
-          vklVdbLevelRes(1) *
-              (int)std::floor(bbox.lower.y / (float)vklVdbLevelRes(1)),
-          vklVdbLevelRes(1) *
-              (int)std::floor(bbox.lower.z / (float)vklVdbLevelRes(1)));
+      return vec3i(res1 * (int)std::floor(bbox.lower.x / (float)res1),
+                   res1 * (int)std::floor(bbox.lower.y / (float)res1),
+                   res1 * (int)std::floor(bbox.lower.z / (float)res1));
     }
 
     /*
      * We don't want to deal with the complexity of negative
      * indices in our tree, so only consider offsets relative to the root node
      * origin.
-     * This function computes these offsets.
+     * This function computes these offsets, and verifies that all leaves lie
+     * within the root node.
      */
-    inline std::vector<vec3ui> computeLeafOffsets(uint64_t numLeaves,
+    inline std::vector<vec3ui> computeLeafOffsets(const VdbTopology &topology,
+                                                  uint64_t numLeaves,
+                                                  const uint32_t *leafLevel,
                                                   const vec3i *leafOrigin,
                                                   const vec3ui &rootOrigin)
     {
       std::vector<vec3ui> leafOffsets(numLeaves);
-      for (size_t i = 0; i < numLeaves; ++i)
-        leafOffsets[i] = static_cast<vec3ui>(leafOrigin[i] - rootOrigin);
+      std::atomic<bool> outsideRoot{false};
+
+      parallelForBlocks(
+          numLeaves, [&](uint64_t b, uint64_t begin, uint64_t end) {
+            for (uint64_t i = begin; i < end; ++i) {
+              const vec3ui offset =
+                  static_cast<vec3ui>(leafOrigin[i] - rootOrigin);
+              const uint32_t upper =
+                  topology.levelRes(0) - topology.levelRes(leafLevel[i]);
+              if (offset.x > upper || offset.y > upper || offset.z > upper)
+                outsideRoot = true;
+              leafOffsets[i] = offset;
+            }
+          });
+
+      if (outsideRoot)
+        runtimeError("input leaves do not fit into a single root level node");
+
       return leafOffsets;
     }
 
     inline vec3ui offsetToNodeOrigin(
+        const VdbTopology &topology,
         const vec3ui &offset,  // offset from the root origin.
         uint32_t level)        // the level the node is on.
     {
       // We get the inner node origin from a given (leaf) voxel offset
       // by masking out lower bits.
-      const uint32_t mask = ~(vklVdbLevelRes(level) - 1);
+      const uint32_t mask = ~(topology.levelRes(level) - 1);
       return vec3ui(offset.x & mask, offset.y & mask, offset.z & mask);
     }
 
-    inline vec3ui offsetToVoxelIndex(const vec3ui &offset, uint32_t level)
+    inline vec3ui offsetToVoxelIndex(const VdbTopology &topology,
+                                     const vec3ui &offset,
+                                     uint32_t level)
     {
       // The lower bits contain the offset from the node origin. We then
       // shift by the log child resolution to obtain the voxel index.
-      const uint32_t mask = vklVdbLevelRes(level) - 1;
-      return vec3ui((offset.x & mask) >> vklVdbLevelTotalLogRes(level + 1),
-                    (offset.y & mask) >> vklVdbLevelTotalLogRes(level + 1),
-                    (offset.z & mask) >> vklVdbLevelTotalLogRes(level + 1));
+      const uint32_t mask  = topology.levelRes(level) - 1;
+      const uint32_t shift = topology.levelTotalLogRes(level + 1);
+      return vec3ui((offset.x & mask) >> shift,
+                    (offset.y & mask) >> shift,
+                    (offset.z & mask) >> shift);
     }
 
-    inline uint64_t offsetToLinearVoxelIndex(const vec3ui &offset,
+    inline uint64_t offsetToLinearVoxelIndex(const VdbTopology &topology,
+                                             const vec3ui &offset,
                                              uint32_t level)
     {
       // The lower bits contain the offset from the node origin. We then
       // shift by the log child resolution to obtain the voxel index.
-      const vec3ui vi = offsetToVoxelIndex(offset, level);
-      return (((uint64_t)vi.x) << (2 * vklVdbLevelResShift(level))) +
-             (((uint64_t)vi.y) << vklVdbLevelResShift(level)) +
-             ((uint64_t)vi.z);
+      const vec3ui vi       = offsetToVoxelIndex(topology, offset, level);
+      const uint32_t logRes = topology.levelLogRes(level);
+      return (((uint64_t)vi.x) << (2 * logRes)) +
+             (((uint64_t)vi.y) << logRes) + ((uint64_t)vi.z);
+    }
+
+    /*
+     * Nodes are identified by a key that is unique on their level, and that
+     * sorts in the same order as node origins (x major, z minor). Keys fit
+     * into 64 bits because commit() rejects topologies with a root
+     * resolution above 2^21.
+     */
+    inline uint32_t nodeKeyBitsPerAxis(const VdbTopology &topology,
+                                       uint32_t level)
+    {
+      return topology.levelTotalLogRes(0) - topology.levelTotalLogRes(level);
     }
 
     /*
-     * Initialize all (inner) levels. To do this, we must
-     * count the number of inner nodes per level, and allocate buffers for
-     * voxels and auxiliary data.
+     * The key of the node on the given level that contains offset.
      */
-    void allocateInnerLevels(
+    inline uint64_t offsetToNodeKey(const VdbTopology &topology,
+                                    const vec3ui &offset,
+                                    uint32_t level)
+    {
+      const uint32_t shift = topology.levelTotalLogRes(level);
+      const uint32_t bits  = nodeKeyBitsPerAxis(topology, level);
+      return (((uint64_t)(offset.x >> shift)) << (2 * bits)) |
+             (((uint64_t)(offset.y >> shift)) << bits) |
+             ((uint64_t)(offset.z >> shift));
+    }
+
+    inline vec3ui nodeKeyToOffset(const VdbTopology &topology,
+                                  uint64_t key,
+                                  uint32_t level)
+    {
+      const uint32_t shift = topology.levelTotalLogRes(level);
+      const uint32_t bits  = nodeKeyBitsPerAxis(topology, level);
+      const uint64_t mask  = (((uint64_t)1) << bits) - 1;
+      return vec3ui(((uint32_t)((key >> (2 * bits)) & mask)) << shift,
+                    ((uint32_t)((key >> bits) & mask)) << shift,
+                    ((uint32_t)(key & mask)) << shift);
+    }
+
+    /*
+     * The offset of the voxel that contains offset in the node array of the
+     * given level. Nodes are stored in key order, so that the node index is
+     * the position of the key in the sorted key list for this level.
+     */
+    inline uint64_t offsetToVoxelOffset(const VdbTopology &topology,
+                                        const std::vector<uint64_t> &nodeKeys,
+                                        const vec3ui &offset,
+                                        uint32_t level)
+    {
+      const uint64_t key = offsetToNodeKey(topology, offset, level);
+      const auto it = std::lower_bound(nodeKeys.begin(), nodeKeys.end(), key);
+      assert(it != nodeKeys.end() && *it == key);
+      const uint64_t nodeIndex = it - nodeKeys.begin();
+      // NOTE: This may exceed 2^32-1 for large trees, in which case
+      // the sampler will use 64 bit addressing (see maxVoxelOffset).
+      return nodeIndex * topology.levelNumVoxels(level) +
+             offsetToLinearVoxelIndex(topology, offset, level);
+    }
+
+    /*
+     * Compute the sorted node keys for each inner level. A leaf on level L
+     * requires one node on each level l < L: the node that contains its
+     * origin. Each level is sorted and deduplicated independently.
+     */
+    std::vector<std::vector<uint64_t>> computeInnerNodeKeys(
+        const VdbTopology &topology,
         const std::vector<vec3ui> &leafOffsets,
-        const std::vector<std::vector<uint64_t>> &binnedLeaves,
-        std::vector<uint64_t> &capacity,
-        VdbGrid *grid,
-        size_t &bytesAllocated)
-    {
-      // Comparator for voxel coordinates. We use this for sorting.
-      const auto isLess = [](const vec3i &a, const vec3i &b) {
-        return (a.x < b.x) || ((a.x == b.x) && (a.y < b.y)) ||
-               ((a.x == b.x) && (a.y == b.y) && (a.z < b.z));
-      };
-
-      // Origins on the previous level. These are offsets from grid->rootOrigin.
-      std::vector<vec3ui> oldInnerOrigins;
-
-      // From the leaf level, go upwards quantizing leaf origins
-      // to the respective level storage resolution, and count all
-      // active nodes.
-      for (int i = 0; i < vklVdbNumLevels() - 1; ++i) {
-        // We traverse bottom-to-top, starting at the leaf level (we will update
-        // the parent level!).
-        const int l = vklVdbNumLevels() - i - 1;
-
-        // Quantize all of this level's leaf origins to the node size, mapping
-        // offsets to inner node origins. We can do this using simple masking
-        // because node resolutions are powers of two.
-        std::vector<vec3ui> innerOrigins;
-        innerOrigins.reserve(oldInnerOrigins.size() + binnedLeaves[l].size());
-        for (uint64_t leaf : binnedLeaves[l])
-          innerOrigins.push_back(offsetToNodeOrigin(leafOffsets[leaf], l - 1));
-
-        // Also quanitize the child level's inner node origins.
-        for (const vec3ui &org : oldInnerOrigins)
-          innerOrigins.push_back(offsetToNodeOrigin(org, l - 1));
-
-        // We now have a list of inner node origins on level l-1, but it
-        // contains duplicates. Sort and remove duplicates, and store for next
-        // iterations.
-        std::sort(innerOrigins.begin(), innerOrigins.end(), isLess);
-        const auto end = std::unique(innerOrigins.begin(), innerOrigins.end());
-        const uint64_t levelNumInner = end - innerOrigins.begin();
-        innerOrigins.resize(levelNumInner);
-        oldInnerOrigins = std::move(innerOrigins);
+        const uint32_t *leafLevel)
+    {
+      const uint32_t numInnerLevels = topology.numLevels - 1;
+      std::vector<std::vector<uint64_t>> nodeKeys(numInnerLevels);
+
+      for (uint32_t l = 0; l < numInnerLevels; ++l) {
+        nodeKeys[l] = parallelSelect(
+            leafOffsets.size(),
+            [&](uint64_t i) { return leafLevel[i] > l; },
+            [&](uint64_t i) {
+              return offsetToNodeKey(topology, leafOffsets[i], l);
+            });
+        parallelRadixSort(nodeKeys[l], 3 * nodeKeyBitsPerAxis(topology, l));
+        parallelUnique(nodeKeys[l]);
+      }
+
+      return nodeKeys;
+    }
 
+    /*
+     * Initialize all (inner) levels. We know the number of inner nodes per
+     * level from computeInnerNodeKeys(), and allocate the voxel buffers.
+     * Auxiliary data is only stored for active voxels, and allocated once
+     * all leaves have been inserted (see computeActiveMasks()).
+     */
+    void allocateInnerLevels(const VdbTopology &topology,
+                             const std::vector<std::vector<uint64_t>> &nodeKeys,
+                             VdbGrid *grid,
+                             size_t &bytesAllocated)
+    {
+      for (uint32_t l = 0; l < nodeKeys.size(); ++l) {
+        const uint64_t levelNumInner = nodeKeys[l].size();
+        VdbLevel &level              = grid->levels[l];
+        level.numNodes               = levelNumInner;
         if (levelNumInner > 0) {
-          assert(l > 1 ||
-                 levelNumInner ==
-                     1);  // This should be true at this point, but make sure...
-          VdbLevel &level = grid->levels[l - 1];
-          capacity[l - 1] = levelNumInner;
           const size_t totalNumVoxels =
-              levelNumInner * vklVdbLevelNumVoxels(l - 1);
-          level.voxels     = allocate<uint64_t>(totalNumVoxels, bytesAllocated);
-          level.valueRange = allocate<range1f>(totalNumVoxels, bytesAllocated);
-          level.leafIndex  = allocate<uint64>(totalNumVoxels, bytesAllocated);
-          range1f empty;
-          std::fill(level.valueRange, level.valueRange + totalNumVoxels, empty);
+              levelNumInner * topology.levelNumVoxels(l);
+          level.voxels = allocate<uint64_t>(totalNumVoxels, bytesAllocated);
         }
       }
     }
 
     /*
-     * Compute the value range for float leaves.
+     * Write child pointers for all inner nodes into their parent voxels.
+     * Each node has exactly one parent voxel, so no synchronization is
+     * needed.
+     */
+    void linkInnerNodes(const VdbTopology &topology,
+                        const std::vector<std::vector<uint64_t>> &nodeKeys,
+                        VdbGrid *grid)
+    {
+      for (uint32_t l = 1; l < nodeKeys.size(); ++l) {
+        const std::vector<uint64_t> &keys = nodeKeys[l];
+        VdbLevel &parentLevel             = grid->levels[l - 1];
+        parallelForBlocks(
+            keys.size(), [&](uint64_t, uint64_t begin, uint64_t end) {
+              for (uint64_t i = begin; i < end; ++i) {
+                const uint64_t v =
+                    offsetToVoxelOffset(topology,
+                                        nodeKeys[l - 1],
+                                        nodeKeyToOffset(topology, keys[i], l),
+                                        l - 1);
+                parentLevel.voxels[v] = vklVdbVoxelMakeChildPtr(i);
+              }
+            });
+      }
+    }
+
+    /*
+     * Compute the value range for float leaves. For DENSE and TUV leaves, the
+     * range covers all time steps. Their data size must have been validated
+     * (see createTemporalLeaves()).
      */
-    range1f computeValueRangeFloat(VKLVdbLeafFormat format,
+    range1f computeValueRangeFloat(const VdbTopology &topology,
+                                   VKLVdbLeafFormat format,
                                    uint32_t level,
                                    const Data *data)
     {
@@ -303,11 +550,16 @@ namespace openvkl {
         break;
       }
 
-      case VKL_VDB_FORMAT_CONSTANT: {
+      case VKL_VDB_FORMAT_CONSTANT:
+      case VKL_VDB_FORMAT_DENSE:
+      case VKL_VDB_FORMAT_TUV: {
+        const size_t numValues = (format == VKL_VDB_FORMAT_CONSTANT)
+                                     ? topology.levelNumVoxels(level)
+                                     : data->size();
         range1f leafRange;
-        CALL_ISPC(VdbSampler_valueRangeConstantFloat,
+        CALL_ISPC(VdbVolume_valueRangeConstantFloat,
                   buffer,
-                  static_cast<uint32_t>(vklVdbLevelNumVoxels(level)),
+                  static_cast<uint32_t>(numValues),
                   reinterpret_cast<ispc::box1f *>(&leafRange));
 
         range.extend(leafRange.lower);
@@ -316,84 +568,963 @@ namespace openvkl {
       }
 
       default:
-        runtimeError(
-            "Only VKL_VDB_FORMAT_TILE and VLK_VDB_FORMAT_CONST are supported.");
+        runtimeError("invalid leaf format ", format);
       }
 
       return range;
     }
 
     /*
-     * Insert leaf nodes into the tree, creating inner nodes as needed.
-     * This function does not allocate anything; allocateInnerLevels() has done
-     * this already.
+     * Optional per leaf parameters for temporally structured (DENSE) and
+     * temporally unstructured (TUV) leaves.
      */
-    void insertLeavesFloat(
-        const std::vector<vec3ui> &leafOffsets,
+    struct TemporalLeafParams
+    {
+      const uint32_t *numTimesteps{nullptr};
+      const Data *const *indices{nullptr};
+      const Data *const *times{nullptr};
+    };
+
+    inline bool isTemporalFormat(VKLVdbLeafFormat format)
+    {
+      return format == VKL_VDB_FORMAT_DENSE || format == VKL_VDB_FORMAT_TUV;
+    }
+
+    /*
+     * Validate the given TUV leaf. Returns an error message, or an empty
+     * string if the leaf is valid.
+     */
+    std::string validateTuvLeaf(const VdbTopology &topology,
+                                uint32_t level,
+                                const Data *data,
+                                const Data *indices,
+                                const Data *times)
+    {
+      const uint64_t numVoxels = topology.levelNumVoxels(level);
+      if (!indices || indices->dataType != VKL_UINT ||
+          indices->size() != numVoxels + 1) {
+        return "temporallyUnstructuredIndices must have "
+               "(number of leaf voxels)+1 VKL_UINT entries";
+      }
+
+      if (!times || times->dataType != VKL_FLOAT ||
+          times->size() != data->size()) {
+        return "temporallyUnstructuredTimes must have one VKL_FLOAT entry "
+               "per value";
+      }
+
+      const uint32_t *idx = indices->begin<uint32_t>();
+      const float *t      = times->begin<float>();
+      if (idx[0] != 0 || idx[numVoxels] != data->size())
+        return "temporallyUnstructuredIndices must span all values";
+
+      for (uint64_t v = 0; v < numVoxels; ++v) {
+        if (idx[v + 1] <= idx[v])
+          return "every voxel must have at least one time step";
+
+        for (uint32_t i = idx[v]; i < idx[v + 1]; ++i) {
+          const bool inRange   = (t[i] >= 0.f && t[i] <= 1.f);
+          const bool ascending = (i == idx[v] || t[i] > t[i - 1]);
+          if (!inRange || !ascending)
+            return "times must be strictly ascending in [0, 1] per voxel";
+        }
+      }
+
+      return std::string();
+    }
+
+    /*
+     * Create headers for all DENSE and TUV leaves, and store them in
+     * leafHeaders.
+     */
+    void createTemporalLeaves(const VdbTopology &topology,
+                              uint64_t numLeaves,
+                              const uint32_t *leafLevel,
+                              const uint32_t *leafFormat,
+                              const Data *const *leafData,
+                              const TemporalLeafParams &params,
+                              VdbGrid *grid,
+                              size_t &bytesAllocated,
+                              std::vector<const void *> &leafHeaders)
+    {
+      std::vector<uint64_t> temporal;
+      for (uint64_t idx = 0; idx < numLeaves; ++idx) {
+        const auto format = static_cast<VKLVdbLeafFormat>(leafFormat[idx]);
+        if (format == VKL_VDB_FORMAT_DENSE && !params.numTimesteps)
+          runtimeError("temporallyStructuredNumTimesteps is not set");
+        if (format == VKL_VDB_FORMAT_TUV && !(params.indices && params.times))
+          runtimeError(
+              "temporallyUnstructuredIndices and temporallyUnstructuredTimes "
+              "must be set");
+        if (isTemporalFormat(format))
+          temporal.push_back(idx);
+      }
+
+      if (temporal.empty())
+        return;
+
+      static_assert(sizeof(VdbTemporalLeaf) % 16 == 0,
+                    "leaf pointers must be aligned to 16 byte boundaries");
+      grid->numTemporalLeaves = temporal.size();
+      grid->temporalLeaves =
+          allocate<VdbTemporalLeaf>(temporal.size(), bytesAllocated);
+
+      std::atomic<uint64_t> invalid{temporal.size()};
+      std::vector<std::string> errors(temporal.size());
+
+      tasking::parallel_for(temporal.size(), [&](uint64_t i) {
+        const uint64_t idx       = temporal[i];
+        const uint32_t level     = leafLevel[idx];
+        const Data *data         = leafData[idx];
+        const uint64_t numVoxels = topology.levelNumVoxels(level);
+        VdbTemporalLeaf &leaf    = grid->temporalLeaves[i];
+        leaf.values              = data->begin<float>();
+        leafHeaders[idx]         = &leaf;
+
+        if (leafFormat[idx] == VKL_VDB_FORMAT_DENSE) {
+          leaf.numTimesteps = params.numTimesteps[idx];
+          if (leaf.numTimesteps == 0 ||
+              data->size() != numVoxels * leaf.numTimesteps) {
+            errors[i] =
+                "data must have temporallyStructuredNumTimesteps values per "
+                "voxel";
+          }
+        } else {
+          errors[i] = validateTuvLeaf(
+              topology, level, data, params.indices[idx], params.times[idx]);
+          if (errors[i].empty()) {
+            leaf.indices = params.indices[idx]->begin<uint32_t>();
+            leaf.times   = params.times[idx]->begin<float>();
+          }
+        }
+
+        if (!errors[i].empty())
+          invalid = i;
+      });
+
+      if (invalid != temporal.size()) {
+        const uint64_t i = invalid;
+        runtimeError("invalid leaf ", temporal[i], ": ", errors[i]);
+      }
+    }
+
+    /*
+     * Create headers for all paged leaves (CONSTANT leaves without data),
+     * and store them in leafHeaders. Returns the input node index of each
+     * paged leaf.
+     */
+    std::vector<uint64_t> createPagedLeaves(
+        uint64_t numLeaves,
         const uint32_t *leafFormat,
         const Data *const *leafData,
-        const std::vector<std::vector<uint64_t>> &binnedLeaves,
-        const std::vector<uint64_t> &capacity,
-        VdbGrid *grid)
-    {
-      assert(capacity[0] == 1);
-      grid->levels[0].numNodes = 1;
-
-      for (size_t leafLevel = 0; leafLevel < binnedLeaves.size(); ++leafLevel) {
-        const auto &leaves = binnedLeaves[leafLevel];
-        for (uint64_t idx : leaves) {
-          const auto format = static_cast<VKLVdbLeafFormat>(leafFormat[idx]);
-          const range1f leafValueRange =
-              computeValueRangeFloat(format, leafLevel, leafData[idx]);
-
-          const vec3ui &offset = leafOffsets[idx];
-          uint64_t nodeIndex   = 0;
-          for (size_t l = 0; l < leafLevel; ++l) {
-            VdbLevel &level = grid->levels[l];
-            // PRECOND: nodeIndex is valid.
-            assert(nodeIndex < level.numNodes);
-
-            const uint64_t voxelIndex = offsetToLinearVoxelIndex(offset, l);
-            // NOTE: If this is every greater than 2^32-1 then we will have to
-            // use 64 bit addressing.
-            const uint64_t v = nodeIndex * vklVdbLevelNumVoxels(l) + voxelIndex;
-            assert(v < ((uint64_t)1) << 32);
-
-            level.valueRange[v].extend(leafValueRange);
-
-            uint64_t &voxel = level.voxels[v];
-            if (vklVdbVoxelIsLeafPtr(voxel) || vklVdbVoxelIsTile(voxel)) {
-              assert(false);
+        const range1f *pagedValueRange,
+        VdbGrid *grid,
+        size_t &bytesAllocated,
+        std::vector<const void *> &leafHeaders)
+    {
+      std::vector<uint64_t> paged;
+      for (uint64_t idx = 0; idx < numLeaves; ++idx) {
+        if (leafData[idx])
+          continue;
+        if (leafFormat[idx] != VKL_VDB_FORMAT_CONSTANT)
+          runtimeError("data is not set for leaf ",
+                       idx,
+                       ", but only VKL_VDB_FORMAT_CONSTANT leaves may be "
+                       "paged");
+        paged.push_back(idx);
+      }
+
+      if (paged.empty())
+        return paged;
+
+      if (!pagedValueRange)
+        runtimeError("pagedValueRange is not set");
+
+      static_assert(sizeof(VdbPagedLeaf) % 16 == 0,
+                    "leaf pointers must be aligned to 16 byte boundaries");
+      grid->numPagedLeaves = paged.size();
+      grid->pagedLeaves = allocate<VdbPagedLeaf>(paged.size(), bytesAllocated);
+
+      for (uint64_t i = 0; i < paged.size(); ++i) {
+        const range1f &range = pagedValueRange[paged[i]];
+        VdbPagedLeaf &leaf   = grid->pagedLeaves[i];
+        leaf.fallback        = 0.5f * (range.lower + range.upper);
+        leafHeaders[paged[i]] = &leaf;
+      }
+
+      return paged;
+    }
+
+    /*
+     * FNV-1a hash of the given leaf values.
+     */
+    inline uint64_t hashLeafValues(const uint32_t *values, uint64_t numValues)
+    {
+      uint64_t hash = 14695981039346656037ull;
+      for (uint64_t i = 0; i < numValues; ++i) {
+        hash ^= values[i];
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    /*
+     * Store the buffer of every CONSTANT leaf that has data in leafHeaders.
+     *
+     * Optionally, leaves whose voxels all have the same value are marked
+     * for storage as tiles (the returned flags), and leaves with
+     * bit-identical values share the buffer of the first such leaf. Leaf
+     * data belongs to the application, so this does not free any buffers,
+     * but collapsed leaves are no longer read during sampling, and shared
+     * buffers are only cached once.
+     */
+    std::vector<uint8_t> compactConstantLeaves(
+        const VdbTopology &topology,
+        uint64_t numLeaves,
+        const uint32_t *leafLevel,
+        const uint32_t *leafFormat,
+        const Data *const *leafData,
+        bool collapseUniformLeaves,
+        bool deduplicateLeaves,
+        std::vector<const void *> &leafHeaders)
+    {
+      std::vector<uint8_t> collapse(numLeaves, 0);
+      std::vector<uint64_t> hashes(deduplicateLeaves ? numLeaves : 0, 0);
+
+      parallelForBlocks(
+          numLeaves, [&](uint64_t, uint64_t begin, uint64_t end) {
+            for (uint64_t idx = begin; idx < end; ++idx) {
+              if (leafFormat[idx] != VKL_VDB_FORMAT_CONSTANT || !leafData[idx])
+                continue;
+
+              leafHeaders[idx] = leafData[idx]->data;
+
+              // Compare bits, so that e.g. -0 and 0 are not merged.
+              const uint32_t *values = leafData[idx]->begin<uint32_t>();
+              const uint64_t numValues =
+                  topology.levelNumVoxels(leafLevel[idx]);
+
+              if (collapseUniformLeaves) {
+                collapse[idx] = std::all_of(
+                    values + 1, values + numValues, [&](uint32_t v) {
+                      return v == values[0];
+                    });
+              }
+
+              if (deduplicateLeaves && !collapse[idx])
+                hashes[idx] = hashLeafValues(values, numValues);
+            }
+          });
+
+      if (!deduplicateLeaves)
+        return collapse;
+
+      // Leaves with distinct values, by hash.
+      std::unordered_map<uint64_t, std::vector<uint64_t>> unique;
+      for (uint64_t idx = 0; idx < numLeaves; ++idx) {
+        if (leafFormat[idx] != VKL_VDB_FORMAT_CONSTANT || !leafData[idx] ||
+            collapse[idx]) {
+          continue;
+        }
+
+        const uint64_t numBytes =
+            topology.levelNumVoxels(leafLevel[idx]) * sizeof(float);
+        std::vector<uint64_t> &candidates = unique[hashes[idx]];
+        bool shared = false;
+        for (uint64_t c : candidates) {
+          if (leafLevel[c] == leafLevel[idx] &&
+              std::memcmp(leafHeaders[c], leafHeaders[idx], numBytes) == 0) {
+            leafHeaders[idx] = leafHeaders[c];
+            shared           = true;
+            break;
+          }
+        }
+
+        if (!shared)
+          candidates.push_back(idx);
+      }
+
+      return collapse;
+    }
+
+    /*
+     * The voxel offset of each leaf on its parent level.
+     */
+    std::vector<uint64_t> computeLeafVoxelOffsets(
+        const VdbTopology &topology,
+        const std::vector<vec3ui> &leafOffsets,
+        const uint32_t *leafLevel,
+        const std::vector<std::vector<uint64_t>> &nodeKeys)
+    {
+      const uint64_t numLeaves = leafOffsets.size();
+      std::vector<uint64_t> leafVoxelOffsets(numLeaves);
+
+      parallelForBlocks(
+          numLeaves, [&](uint64_t, uint64_t begin, uint64_t end) {
+            for (uint64_t idx = begin; idx < end; ++idx) {
+              // Leaves on level L are stored in voxels on level L-1.
+              const uint32_t l      = leafLevel[idx] - 1;
+              leafVoxelOffsets[idx] = offsetToVoxelOffset(
+                  topology, nodeKeys[l], leafOffsets[idx], l);
+            }
+          });
+
+      return leafVoxelOffsets;
+    }
+
+    /*
+     * The number of bits required to represent the given value.
+     */
+    inline uint32_t numBitsRequired(uint64_t value)
+    {
+      uint32_t bits = 0;
+      while (bits < 64 && (value >> bits) != 0)
+        ++bits;
+      return bits;
+    }
+
+    /*
+     * Leaves that share a voxel would write it concurrently in
+     * insertLeavesFloat(). Find them before inserting anything by sorting the
+     * leaf voxel offsets on each level.
+     */
+    void checkDuplicateLeaves(const VdbTopology &topology,
+                              const std::vector<uint64_t> &leafVoxelOffsets,
+                              const std::vector<vec3ui> &leafOffsets,
+                              const uint32_t *leafLevel,
+                              const VdbGrid *grid)
+    {
+      const uint64_t numLeaves = leafVoxelOffsets.size();
+      for (uint32_t l = 0; l + 1 < topology.numLevels; ++l) {
+        const uint64_t numVoxels =
+            grid->levels[l].numNodes * topology.levelNumVoxels(l);
+        if (numVoxels == 0)
+          continue;
+
+        std::vector<uint64_t> keys = parallelSelect(
+            numLeaves,
+            [&](uint64_t i) { return leafLevel[i] == l + 1; },
+            [&](uint64_t i) { return leafVoxelOffsets[i]; });
+        parallelRadixSort(keys, numBitsRequired(numVoxels - 1));
+
+        std::atomic<uint64_t> duplicate{numVoxels};
+        parallelForBlocks(
+            keys.size(), [&](uint64_t, uint64_t begin, uint64_t end) {
+              for (uint64_t i = std::max<uint64_t>(begin, 1); i < end; ++i) {
+                if (keys[i] == keys[i - 1])
+                  duplicate = keys[i];
+              }
+            });
+
+        if (duplicate != numVoxels) {
+          for (uint64_t idx = 0; idx < numLeaves; ++idx) {
+            if (leafLevel[idx] == l + 1 && leafVoxelOffsets[idx] == duplicate)
               runtimeError(
                   "Attempted to insert a leaf node into a leaf node (level ",
-                  l + 1,
+                  leafLevel[idx],
                   ", origin ",
-                  offsetToNodeOrigin(offset, l),
+                  leafOffsets[idx],
                   ")");
+          }
+        }
+      }
+    }
 
-            } else if (vklVdbVoxelIsEmpty(voxel)) {
-              const size_t nl = l + 1;
-              if (nl < leafLevel) {
-                nodeIndex = grid->levels[nl].numNodes++;
-                assert(grid->levels[nl].numNodes <= capacity[nl]);
-                voxel = vklVdbVoxelMakeChildPtr(nodeIndex);
-              } else {
-                if (format == VKL_VDB_FORMAT_TILE) {
-                  voxel = vklVdbVoxelMakeTile(leafData[idx]->begin<float>()[0]);
-                } else if (format == VKL_VDB_FORMAT_CONSTANT)
-                  voxel = vklVdbVoxelMakeLeafPtr(leafData[idx]->data, format);
-                else
-                  assert(false);
-
-                level.leafIndex[v] = idx;
+    /*
+     * Insert leaf nodes into the tree. All inner nodes exist and are linked
+     * already (see linkInnerNodes()), and checkDuplicateLeaves() guarantees
+     * that every leaf has a voxel of its own, so leaves are inserted in
+     * parallel.
+     */
+    void insertLeavesFloat(const std::vector<uint64_t> &leafVoxelOffsets,
+                           const std::vector<vec3ui> &leafOffsets,
+                           const uint32_t *leafLevel,
+                           const uint32_t *leafFormat,
+                           const Data *const *leafData,
+                           const std::vector<const void *> &leafHeaders,
+                           const std::vector<uint8_t> &collapsedLeaves,
+                           VdbGrid *grid)
+    {
+      const uint64_t numLeaves = leafOffsets.size();
+      std::atomic<bool> hasInvalidFormat{false};
+      std::atomic<uint64_t> collision{numLeaves};
+
+      parallelForBlocks(
+          numLeaves, [&](uint64_t, uint64_t begin, uint64_t end) {
+            for (uint64_t idx = begin; idx < end; ++idx) {
+              const auto format =
+                  static_cast<VKLVdbLeafFormat>(leafFormat[idx]);
+              if (format >= VKL_VDB_FORMAT_INVALID) {
+                hasInvalidFormat = true;
+                continue;
               }
-            } else {
-              nodeIndex = vklVdbVoxelChildGetIndex(voxel);
-              assert(nodeIndex < grid->levels[l + 1].numNodes);
+
+              // A child pointer means that there are leaves below this one.
+              VdbLevel &level = grid->levels[leafLevel[idx] - 1];
+              uint64_t &voxel = level.voxels[leafVoxelOffsets[idx]];
+              if (!vklVdbVoxelIsEmpty(voxel)) {
+                collision = idx;
+                continue;
+              }
+
+              // Paged leaves use the otherwise unused TILE format.
+              if (format == VKL_VDB_FORMAT_TILE || collapsedLeaves[idx])
+                voxel = vklVdbVoxelMakeTile(leafData[idx]->begin<float>()[0]);
+              else if (!leafData[idx])
+                voxel = vklVdbVoxelMakeLeafPtr(leafHeaders[idx],
+                                               VKL_VDB_FORMAT_TILE);
+              else
+                voxel = vklVdbVoxelMakeLeafPtr(leafHeaders[idx], format);
             }
+          });
+
+      if (hasInvalidFormat)
+        runtimeError("invalid leaf format");
+
+      if (collision != numLeaves) {
+        const uint64_t idx = collision;
+        runtimeError(
+            "Attempted to insert a leaf node into a leaf node (level ",
+            leafLevel[idx],
+            ", origin ",
+            leafOffsets[idx],
+            ")");
+      }
+    }
+
+    /*
+     * Portable 64 bit population count.
+     */
+    inline uint64_t popcount64(uint64_t x)
+    {
+      x = x - ((x >> 1) & 0x5555555555555555ull);
+      x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+      x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+      return (x * 0x0101010101010101ull) >> 56;
+    }
+
+    inline uint64_t numMaskWords(const VdbTopology &topology,
+                                 const VdbLevel &level,
+                                 uint32_t l)
+    {
+      return (level.numNodes * topology.levelNumVoxels(l) + 63) / 64;
+    }
+
+    inline uint64_t numActiveVoxels(const VdbTopology &topology,
+                                    const VdbLevel &level,
+                                    uint32_t l)
+    {
+      return level.activePrefix
+                 ? level.activePrefix[numMaskWords(topology, level, l)]
+                 : 0;
+    }
+
+    /*
+     * The index of the auxiliary data for the given voxel. This is the
+     * number of active voxels before voxelOffset, so it is also valid for
+     * inactive voxels and for voxelOffset == total number of voxels.
+     * Must match VdbGrid_activeIndex().
+     */
+    inline uint64_t activeIndex(const VdbLevel &level, uint64_t voxelOffset)
+    {
+      const uint64_t word = voxelOffset >> 6;
+      const uint64_t bit  = voxelOffset & 63;
+      uint64_t index      = level.activePrefix[word];
+      if (bit > 0) {
+        const uint64_t below = (((uint64_t)1) << bit) - 1;
+        index += popcount64(level.activeMask[word] & below);
+      }
+      return index;
+    }
+
+    /*
+     * Compute the active voxel mask and its prefix sum for all inner
+     * levels. This must happen after all leaves have been inserted.
+     */
+    void computeActiveMasks(const VdbTopology &topology,
+                            VdbGrid *grid,
+                            size_t &bytesAllocated)
+    {
+      for (uint32_t l = 0; l + 1 < topology.numLevels; ++l) {
+        VdbLevel &level = grid->levels[l];
+        const uint64_t numVoxels =
+            level.numNodes * topology.levelNumVoxels(l);
+        if (numVoxels == 0)
+          continue;
+
+        const uint64_t numWords = numMaskWords(topology, level, l);
+        level.activeMask   = allocate<uint64_t>(numWords, bytesAllocated);
+        level.activePrefix = allocate<uint64_t>(numWords + 1, bytesAllocated);
+
+        const uint64_t numBlocks = numCommitBlocks(numWords);
+        std::vector<uint64_t> blockOffset(numBlocks + 1, 0);
+        parallelForBlocks(
+            numWords, [&](uint64_t b, uint64_t begin, uint64_t end) {
+              uint64_t count = 0;
+              for (uint64_t w = begin; w < end; ++w) {
+                const uint64_t vBegin = w * 64;
+                const uint64_t vEnd   = std::min(vBegin + 64, numVoxels);
+                uint64_t mask         = 0;
+                for (uint64_t v = vBegin; v < vEnd; ++v) {
+                  if (!vklVdbVoxelIsEmpty(level.voxels[v]))
+                    mask |= ((uint64_t)1) << (v - vBegin);
+                }
+                level.activeMask[w] = mask;
+                count += popcount64(mask);
+              }
+              blockOffset[b + 1] = count;
+            });
+
+        for (uint64_t b = 0; b < numBlocks; ++b)
+          blockOffset[b + 1] += blockOffset[b];
+
+        parallelForBlocks(
+            numWords, [&](uint64_t b, uint64_t begin, uint64_t end) {
+              uint64_t o = blockOffset[b];
+              for (uint64_t w = begin; w < end; ++w) {
+                level.activePrefix[w] = o;
+                o += popcount64(level.activeMask[w]);
+              }
+            });
+        level.activePrefix[numWords] = blockOffset[numBlocks];
+      }
+    }
+
+    /*
+     * Propagate value ranges from the leaves up to the root. The active
+     * voxels of a node are contiguous, and every inner node writes the union
+     * of their ranges into its parent voxel, so this is parallel over the
+     * nodes on each level.
+     */
+    void propagateValueRanges(
+        const VdbTopology &topology,
+        const std::vector<std::vector<uint64_t>> &nodeKeys,
+        const VdbGrid *grid,
+        std::vector<std::vector<range1f>> &ranges)
+    {
+      const uint32_t numInnerLevels = nodeKeys.size();
+      for (uint32_t l = numInnerLevels - 1; l > 0; --l) {
+        const std::vector<uint64_t> &keys = nodeKeys[l];
+        const VdbLevel &level             = grid->levels[l];
+        const VdbLevel &parentLevel       = grid->levels[l - 1];
+        const uint64_t numVoxels          = topology.levelNumVoxels(l);
+
+        tasking::parallel_for(keys.size(), [&](uint64_t i) {
+          range1f range;
+          const uint64_t begin = activeIndex(level, i * numVoxels);
+          const uint64_t end   = activeIndex(level, (i + 1) * numVoxels);
+          for (uint64_t a = begin; a < end; ++a)
+            range.extend(ranges[l][a]);
+
+          const uint64_t pv =
+              offsetToVoxelOffset(topology,
+                                  nodeKeys[l - 1],
+                                  nodeKeyToOffset(topology, keys[i], l),
+                                  l - 1);
+          ranges[l - 1][activeIndex(parentLevel, pv)] = range;
+        });
+      }
+    }
+
+    /*
+     * Compute value ranges for all active voxels, indexed by active index.
+     * Leaf ranges are computed from leaf data, and then propagated up to the
+     * root (see propagateValueRanges()).
+     */
+    std::vector<std::vector<range1f>> computeValueRanges(
+        const VdbTopology &topology,
+        const std::vector<uint64_t> &leafVoxelOffsets,
+        const uint32_t *leafLevel,
+        const uint32_t *leafFormat,
+        const Data *const *leafData,
+        const range1f *pagedValueRange,
+        const std::vector<std::vector<uint64_t>> &nodeKeys,
+        const VdbGrid *grid)
+    {
+      const uint32_t numInnerLevels = nodeKeys.size();
+      std::vector<std::vector<range1f>> ranges(numInnerLevels);
+      for (uint32_t l = 0; l < numInnerLevels; ++l)
+        ranges[l].resize(numActiveVoxels(topology, grid->levels[l], l));
+
+      parallelForBlocks(
+          leafVoxelOffsets.size(),
+          [&](uint64_t, uint64_t begin, uint64_t end) {
+            for (uint64_t idx = begin; idx < end; ++idx) {
+              const uint32_t l = leafLevel[idx] - 1;
+              const auto format =
+                  static_cast<VKLVdbLeafFormat>(leafFormat[idx]);
+              ranges[l][activeIndex(grid->levels[l], leafVoxelOffsets[idx])] =
+                  leafData[idx]
+                      ? computeValueRangeFloat(
+                            topology, format, l + 1, leafData[idx])
+                      : pagedValueRange[idx];
+            }
+          });
+
+      propagateValueRanges(topology, nodeKeys, grid, ranges);
+
+      return ranges;
+    }
+
+    /*
+     * The number of voxels that the filter reads below and above the voxel
+     * that contains the sample position (see VdbSampler.ispc).
+     */
+    struct FilterStencil
+    {
+      int before{0};
+      int after{0};
+    };
+
+    inline FilterStencil filterStencil(VKLFilter filter)
+    {
+      FilterStencil stencil;
+      if (filter == VKL_FILTER_TRILINEAR) {
+        stencil.after = 1;
+      } else if (filter == VKL_FILTER_TRICUBIC) {
+        // The B-spline stencil starts one voxel below.
+        stencil.before = 1;
+        stencil.after  = 2;
+      }
+      return stencil;
+    }
+
+    /*
+     * The value range of the voxel that contains the given offset, on the
+     * given level or the first level above it that does not have a child
+     * node there. Empty voxels and offsets outside the root node sample as
+     * zero.
+     */
+    range1f findValueRange(const VdbTopology &topology,
+                           const VdbGrid *grid,
+                           const std::vector<std::vector<range1f>> &ranges,
+                           const vec3i &offset,
+                           uint32_t maxLevel)
+    {
+      const int rootRes = topology.levelRes(0);
+      if (offset.x < 0 || offset.y < 0 || offset.z < 0 ||
+          offset.x >= rootRes || offset.y >= rootRes || offset.z >= rootRes) {
+        return range1f(0.f, 0.f);
+      }
+
+      const vec3ui o(offset.x, offset.y, offset.z);
+      uint64_t nodeIndex = 0;
+      for (uint32_t l = 0;; ++l) {
+        const VdbLevel &level = grid->levels[l];
+        const uint64_t v      = nodeIndex * topology.levelNumVoxels(l) +
+                           offsetToLinearVoxelIndex(topology, o, l);
+        const uint64_t voxel = level.voxels[v];
+        if (vklVdbVoxelIsEmpty(voxel))
+          return range1f(0.f, 0.f);
+        if (l == maxLevel || !vklVdbVoxelIsChildPtr(voxel))
+          return ranges[l][activeIndex(level, v)];
+        nodeIndex = vklVdbVoxelChildGetIndex(voxel);
+      }
+    }
+
+    /*
+     * Widen the value ranges of leaves and tiles by the values that the
+     * filter reads outside of them, so that they bound all samples inside
+     * their domain. Iterators cull nodes by these ranges, and use them as
+     * majorants. Neighbor values are bounded by the exact range of the
+     * neighboring voxel on the same level, which may be an inner node.
+     */
+    std::vector<std::vector<range1f>> computeFilterValueRanges(
+        const VdbTopology &topology,
+        const std::vector<std::vector<uint64_t>> &nodeKeys,
+        const VdbGrid *grid,
+        const std::vector<std::vector<range1f>> &ranges,
+        VKLFilter filter)
+    {
+      std::vector<std::vector<range1f>> filterRanges = ranges;
+
+      const FilterStencil stencil = filterStencil(filter);
+      if (stencil.before == 0 && stencil.after == 0)
+        return filterRanges;
+
+      for (uint32_t l = 0; l < nodeKeys.size(); ++l) {
+        const VdbLevel &level    = grid->levels[l];
+        const uint64_t numVoxels = topology.levelNumVoxels(l);
+        const uint32_t logRes    = topology.levelLogRes(l);
+        const uint32_t voxelRes  = 1u << topology.levelTotalLogRes(l + 1);
+
+        tasking::parallel_for(nodeKeys[l].size(), [&](uint64_t i) {
+          const vec3ui nodeOffset =
+              nodeKeyToOffset(topology, nodeKeys[l][i], l);
+
+          for (uint64_t lin = 0; lin < numVoxels; ++lin) {
+            const uint64_t v     = i * numVoxels + lin;
+            const uint64_t voxel = level.voxels[v];
+            if (vklVdbVoxelIsEmpty(voxel) || vklVdbVoxelIsChildPtr(voxel))
+              continue;
+
+            const uint32_t mask = (1u << logRes) - 1;
+            const vec3i lower(
+                nodeOffset.x + ((uint32_t)(lin >> (2 * logRes)) & mask) *
+                                   voxelRes,
+                nodeOffset.y + ((uint32_t)(lin >> logRes) & mask) * voxelRes,
+                nodeOffset.z + ((uint32_t)lin & mask) * voxelRes);
+
+            // Coordinate 0 on an axis stands for the whole voxel extent on
+            // that axis, and the others for the voxels the stencil reaches
+            // below and above it.
+            range1f &range  = filterRanges[l][activeIndex(level, v)];
+            const int begin = -stencil.before;
+            const int end   = stencil.after;
+            const int r     = voxelRes - 1;
+            for (int x = begin; x <= end; ++x)
+              for (int y = begin; y <= end; ++y)
+                for (int z = begin; z <= end; ++z) {
+                  if (x == 0 && y == 0 && z == 0)
+                    continue;
+                  const vec3i neighbor(lower.x + (x > 0 ? r + x : x),
+                                       lower.y + (y > 0 ? r + y : y),
+                                       lower.z + (z > 0 ? r + z : z));
+                  range.extend(
+                      findValueRange(topology, grid, ranges, neighbor, l));
+                }
           }
-        }
+        });
+      }
+
+      propagateValueRanges(topology, nodeKeys, grid, filterRanges);
+
+      return filterRanges;
+    }
+
+    /*
+     * Half precision conversion (round to nearest even).
+     */
+    inline uint16_t floatToHalf(float f)
+    {
+      uint32_t x;
+      std::memcpy(&x, &f, sizeof(x));
+      const uint32_t sign = (x >> 16) & 0x8000;
+      const uint32_t absx = x & 0x7fffffff;
+
+      if (absx >= 0x7f800000)  // inf, nan
+        return sign | 0x7c00 | (absx > 0x7f800000 ? 0x200 : 0);
+
+      if (absx >= 0x477ff000)  // rounds to inf
+        return sign | 0x7c00;
+
+      if (absx < 0x38800000) {  // subnormal
+        const float scaled = std::fabs(f) * 16777216.f;
+        return sign | static_cast<uint32_t>(std::nearbyint(scaled));
+      }
+
+      const uint32_t mant = absx & 0x7fffff;
+      const uint32_t exp  = (absx >> 23) - 127 + 15;
+      uint32_t h          = (exp << 10) | (mant >> 13);
+      const uint32_t rem  = mant & 0x1fff;
+      if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+        ++h;
+      return sign | h;
+    }
+
+    inline float halfToFloat(uint16_t h)
+    {
+      const uint32_t sign = ((uint32_t)(h & 0x8000)) << 16;
+      const uint32_t exp  = (h >> 10) & 0x1f;
+      const uint32_t mant = h & 0x3ff;
+
+      if (exp == 0) {
+        const float f = mant * (1.f / 16777216.f);
+        return sign ? -f : f;
       }
+
+      const uint32_t x = (exp == 0x1f)
+                             ? (sign | 0x7f800000 | (mant << 13))
+                             : (sign | ((exp + 112) << 23) | (mant << 13));
+      float f;
+      std::memcpy(&f, &x, sizeof(f));
+      return f;
+    }
+
+    /*
+     * The largest half that is not greater than f.
+     */
+    inline uint16_t floatToHalfDown(float f)
+    {
+      uint16_t h = floatToHalf(f);
+      if (halfToFloat(h) > f)
+        h = (h & 0x8000) ? h + 1 : (h == 0 ? 0x8001 : h - 1);
+      return h;
+    }
+
+    /*
+     * The smallest half that is not less than f.
+     */
+    inline uint16_t floatToHalfUp(float f)
+    {
+      uint16_t h = floatToHalf(f);
+      if (halfToFloat(h) < f)
+        h = (h & 0x8000) ? (h == 0x8000 ? 0x0001 : h - 1) : h + 1;
+      return h;
+    }
+
+    /*
+     * Store value ranges in the grid. We round conservatively, so that
+     * the stored range always contains the exact range.
+     */
+    void storeValueRanges(const std::vector<std::vector<range1f>> &ranges,
+                          VdbGrid *grid,
+                          size_t &bytesAllocated)
+    {
+      for (uint32_t l = 0; l < ranges.size(); ++l) {
+        const std::vector<range1f> &levelRanges = ranges[l];
+        if (levelRanges.empty())
+          continue;
+
+        VdbLevel &level = grid->levels[l];
+        level.valueRange =
+            allocate<uint16_t>(2 * levelRanges.size(), bytesAllocated);
+        parallelForBlocks(
+            levelRanges.size(), [&](uint64_t, uint64_t begin, uint64_t end) {
+              for (uint64_t a = begin; a < end; ++a) {
+                const range1f &r            = levelRanges[a];
+                level.valueRange[2 * a]     = floatToHalfDown(r.lower);
+                level.valueRange[2 * a + 1] = floatToHalfUp(r.upper);
+              }
+            });
+      }
+    }
+
+    /*
+     * The mean value of the given float leaf. For DENSE and TUV leaves, this
+     * is the mean over all time steps.
+     */
+    double computeMeanFloat(const VdbTopology &topology,
+                            VKLVdbLeafFormat format,
+                            uint32_t level,
+                            const Data *data)
+    {
+      const float *buffer = data->begin<float>();
+      if (format == VKL_VDB_FORMAT_TILE)
+        return buffer[0];
+
+      const size_t numValues = (format == VKL_VDB_FORMAT_CONSTANT)
+                                   ? topology.levelNumVoxels(level)
+                                   : data->size();
+      double sum = 0.0;
+      for (size_t i = 0; i < numValues; ++i)
+        sum += buffer[i];
+      return numValues > 0 ? sum / numValues : 0.0;
+    }
+
+    /*
+     * Compute the mean value of all active voxels for level of detail
+     * sampling. Leaf means are computed from leaf data (paged leaves use the
+     * midpoint of their value range), and then averaged from the leaves up
+     * to the root, in the same way as propagateValueRanges(). Empty voxels
+     * count as 0.
+     */
+    void computeMeans(const VdbTopology &topology,
+                      const std::vector<uint64_t> &leafVoxelOffsets,
+                      const uint32_t *leafLevel,
+                      const uint32_t *leafFormat,
+                      const Data *const *leafData,
+                      const range1f *pagedValueRange,
+                      const std::vector<std::vector<uint64_t>> &nodeKeys,
+                      VdbGrid *grid,
+                      size_t &bytesAllocated)
+    {
+      const uint32_t numInnerLevels = nodeKeys.size();
+      for (uint32_t l = 0; l < numInnerLevels; ++l) {
+        VdbLevel &level = grid->levels[l];
+        const uint64_t numActive = numActiveVoxels(topology, level, l);
+        if (numActive > 0)
+          level.mean = allocate<float>(numActive, bytesAllocated);
+      }
+
+      parallelForBlocks(
+          leafVoxelOffsets.size(),
+          [&](uint64_t, uint64_t begin, uint64_t end) {
+            for (uint64_t idx = begin; idx < end; ++idx) {
+              const uint32_t l = leafLevel[idx] - 1;
+              const auto format =
+                  static_cast<VKLVdbLeafFormat>(leafFormat[idx]);
+              float mean;
+              if (leafData[idx]) {
+                mean = static_cast<float>(computeMeanFloat(
+                    topology, format, l + 1, leafData[idx]));
+              } else {
+                const range1f &r = pagedValueRange[idx];
+                mean             = 0.5f * (r.lower + r.upper);
+              }
+              VdbLevel &level = grid->levels[l];
+              level.mean[activeIndex(level, leafVoxelOffsets[idx])] = mean;
+            }
+          });
+
+      for (uint32_t l = numInnerLevels - 1; l > 0; --l) {
+        const std::vector<uint64_t> &keys = nodeKeys[l];
+        const VdbLevel &level             = grid->levels[l];
+        VdbLevel &parentLevel             = grid->levels[l - 1];
+        const uint64_t numVoxels          = topology.levelNumVoxels(l);
+
+        tasking::parallel_for(keys.size(), [&](uint64_t i) {
+          double sum           = 0.0;
+          const uint64_t begin = activeIndex(level, i * numVoxels);
+          const uint64_t end   = activeIndex(level, (i + 1) * numVoxels);
+          for (uint64_t a = begin; a < end; ++a)
+            sum += level.mean[a];
+
+          const uint64_t pv =
+              offsetToVoxelOffset(topology,
+                                  nodeKeys[l - 1],
+                                  nodeKeyToOffset(topology, keys[i], l),
+                                  l - 1);
+          parentLevel.mean[activeIndex(parentLevel, pv)] =
+              static_cast<float>(sum / numVoxels);
+        });
+      }
+    }
+
+    /*
+     * Build the map from active voxels to original leaf indices. This is
+     * only needed for the LeafNodeAccess observer, but the leaf parameters
+     * may change after commit, so we build it here.
+     */
+    void computeLeafIndex(const VdbTopology &topology,
+                          const std::vector<uint64_t> &leafVoxelOffsets,
+                          const uint32_t *leafLevel,
+                          VdbGrid *grid,
+                          size_t &bytesAllocated)
+    {
+      for (uint32_t l = 0; l + 1 < topology.numLevels; ++l) {
+        VdbLevel &level          = grid->levels[l];
+        const uint64_t numActive = numActiveVoxels(topology, level, l);
+        if (numActive > 0)
+          level.leafIndex = allocate<uint64_t>(numActive, bytesAllocated);
+      }
+
+      parallelForBlocks(
+          leafVoxelOffsets.size(),
+          [&](uint64_t, uint64_t begin, uint64_t end) {
+            for (uint64_t idx = begin; idx < end; ++idx) {
+              VdbLevel &level  = grid->levels[leafLevel[idx] - 1];
+              const uint64_t v = leafVoxelOffsets[idx];
+              level.leafIndex[activeIndex(level, v)] = idx;
+            }
+          });
+    }
+
+    /*
+     * Compute the largest voxel offset on any inner level. The sampler uses
+     * 32 bit traversal if this fits into 32 bits.
+     */
+    uint64_t computeMaxVoxelOffset(const VdbTopology &topology,
+                                   const VdbGrid *grid)
+    {
+      uint64_t maxVoxelOffset = 0;
+      for (uint32_t l = 0; l + 1 < topology.numLevels; ++l) {
+        const uint64_t numVoxels =
+            grid->levels[l].numNodes * topology.levelNumVoxels(l);
+        if (numVoxels > 0)
+          maxVoxelOffset = std::max(maxVoxelOffset, numVoxels - 1);
+      }
+      return maxVoxelOffset;
     }
 
     AffineSpace3f loadTransform(const Ref<Data> &dataIndexToObject)
@@ -435,10 +1566,11 @@ namespace openvkl {
           (VKLDataType)this->template getParam<int>("type", VKL_UNKNOWN);
       const VKLFilter filter = (VKLFilter)this->template getParam<int>(
           "filter", VKL_FILTER_TRILINEAR);
-      const int maxSamplingDepth = this->template getParam<int>(
-          "maxSamplingDepth", VKL_VDB_NUM_LEVELS - 1);
-      const int maxIteratorDepth =
-          this->template getParam<int>("maxIteratorDepth", 3);
+      // Base-2 log resolution per level (root first). This selects one of
+      // the topologies in VdbTopologies.h.
+      Ref<Data> dataLogResolution =
+          (Data *)this->template getParam<ManagedObject::VKL_PTR>(
+              "logResolution", nullptr);
       Ref<Data> dataIndexToObject =
           (Data *)this->template getParam<ManagedObject::VKL_PTR>(
               "indexToObject", nullptr);
@@ -457,6 +1589,57 @@ namespace openvkl {
       Ref<Data> dataData =
           (Data *)this->template getParam<ManagedObject::VKL_PTR>("data",
                                                                   nullptr);
+      // Per leaf, only read for VKL_VDB_FORMAT_DENSE leaves.
+      Ref<Data> dataNumTimesteps =
+          (Data *)this->template getParam<ManagedObject::VKL_PTR>(
+              "temporallyStructuredNumTimesteps", nullptr);
+      // Per leaf, only read for VKL_VDB_FORMAT_TUV leaves.
+      Ref<Data> dataTuvIndices =
+          (Data *)this->template getParam<ManagedObject::VKL_PTR>(
+              "temporallyUnstructuredIndices", nullptr);
+      Ref<Data> dataTuvTimes =
+          (Data *)this->template getParam<ManagedObject::VKL_PTR>(
+              "temporallyUnstructuredTimes", nullptr);
+      // Leaves that have no data are paged in through the loader.
+      const auto leafLoader = reinterpret_cast<VKLVdbLeafLoader>(
+          this->template getParam<void *>("leafLoader", nullptr));
+      void *leafLoaderUserData =
+          this->template getParam<void *>("leafLoaderUserData", nullptr);
+      const int maxResidentLeaves =
+          this->template getParam<int>("maxResidentLeaves", 1024);
+      const bool waitForLeafLoads =
+          this->template getParam<bool>("waitForLeafLoads", false);
+      // Optional compaction of CONSTANT leaves.
+      const bool collapseUniformLeaves =
+          this->template getParam<bool>("collapseUniformLeaves", false);
+      const bool deduplicateLeaves =
+          this->template getParam<bool>("deduplicateLeaves", false);
+      // VKL_BOX1F values, one per leaf. Only read for paged leaves.
+      Ref<Data> dataPagedValueRange =
+          (Data *)this->template getParam<ManagedObject::VKL_PTR>(
+              "pagedValueRange", nullptr);
+
+      topology = &getVdbTopology(0);
+      if (dataLogResolution) {
+        if (dataLogResolution->dataType != VKL_UINT)
+          runtimeError("logResolution must have type VKL_UINT");
+        topology = findVdbTopology(dataLogResolution->begin<uint32_t>(),
+                                   dataLogResolution->size());
+        if (!topology)
+          runtimeError(
+              "logResolution does not match any of the topologies that "
+              "Open VKL was built with (see VKL_VDB_EXTRA_LOG_RESOLUTIONS)");
+      }
+
+      // The sampler computes domain offsets in 32 bit, and node keys must
+      // fit into 64 bits.
+      if (topology->levelTotalLogRes(0) > 21)
+        runtimeError("the root node resolution must not exceed 2^21");
+
+      const int maxSamplingDepth = this->template getParam<int>(
+          "maxSamplingDepth", topology->numLevels - 1);
+      const int maxIteratorDepth = this->template getParam<int>(
+          "maxIteratorDepth", topology->numLevels - 1);
 
       // Sanity checks.
       // We will assume that the following conditions hold downstream, so
@@ -493,13 +1676,35 @@ namespace openvkl {
       const uint32_t *leafFormat  = dataFormat->begin<uint32_t>();
       const Data *const *leafData = dataData->begin<const Data *>();
 
+      const Data *temporalData[] = {
+          dataNumTimesteps.ptr, dataTuvIndices.ptr, dataTuvTimes.ptr};
+      for (const Data *d : temporalData) {
+        if (d && d->size() != numLeaves) {
+          runtimeError(
+              "temporallyStructuredNumTimesteps, "
+              "temporallyUnstructuredIndices, and "
+              "temporallyUnstructuredTimes must have one entry per leaf");
+        }
+      }
+
+      if (dataPagedValueRange && dataPagedValueRange->size() != numLeaves)
+        runtimeError("pagedValueRange must have one entry per leaf");
+
+      if (maxResidentLeaves < 1)
+        runtimeError("maxResidentLeaves must be positive");
+
+      TemporalLeafParams temporalParams;
+      temporalParams.numTimesteps = getDataPtr<uint32_t>(dataNumTimesteps.ptr);
+      temporalParams.indices = getDataPtr<const Data *>(dataTuvIndices.ptr);
+      temporalParams.times   = getDataPtr<const Data *>(dataTuvTimes.ptr);
+
       grid         = allocate<VdbGrid>(1, bytesAllocated);
       grid->type   = type;
       grid->filter = filter;
       grid->maxSamplingDepth =
-          min(max(maxSamplingDepth, 0), VKL_VDB_NUM_LEVELS - 1);
+          min(max(maxSamplingDepth, 0), (int)topology->numLevels - 1);
       grid->maxIteratorDepth =
-          min(max(maxIteratorDepth, 0), VKL_VDB_NUM_LEVELS - 1);
+          min(max(maxIteratorDepth, 0), (int)topology->numLevels - 1);
       grid->totalNumLeaves = numLeaves;
 
       const AffineSpace3f indexToObject = loadTransform(dataIndexToObject);
@@ -510,36 +1715,140 @@ namespace openvkl {
       objectToIndex.p = -(objectToIndex.l * indexToObject.p);
       writeTransform(objectToIndex, grid->objectToIndex);
 
-      const box3i bbox = computeBbox(numLeaves, leafLevel, leafOrigin);
-      grid->rootOrigin = computeRootOrigin(bbox);
+      if (numLeaves == 0)
+        runtimeError("there must be at least one leaf node");
+
+      const auto numLeavesPerLevel =
+          countLeavesPerLevel(*topology, numLeaves, leafLevel);
+      for (size_t i = 0; i < topology->numLevels; ++i)
+        grid->numLeaves[i] = numLeavesPerLevel[i];
+
+      const box3i bbox =
+          computeBbox(*topology, numLeaves, leafLevel, leafOrigin);
+      grid->rootOrigin = computeRootOrigin(*topology, bbox);
 
       // VKL requires a float bbox. This is stored on the base class Volume.
       bounds.lower = xfmPoint(grid->indexToObject, vec3f(bbox.lower));
       bounds.upper = xfmPoint(grid->indexToObject, vec3f(bbox.upper));
 
-      const auto binnedLeaves = binLeavesPerLevel(numLeaves, leafLevel);
-      for (size_t i = 0; i < vklVdbNumLevels(); ++i)
-        grid->numLeaves[i] = binnedLeaves[i].size();
-      const auto leafOffsets =
-          computeLeafOffsets(numLeaves, leafOrigin, grid->rootOrigin);
-
-      // Allocate buffers for all levels now, all in one go. This makes
-      // inserting the nodes (below) much faster.
-      std::vector<uint64_t> capacity(vklVdbNumLevels() - 1, 0);
-      allocateInnerLevels(
-          leafOffsets, binnedLeaves, capacity, grid, bytesAllocated);
+      const auto leafOffsets = computeLeafOffsets(
+          *topology, numLeaves, leafLevel, leafOrigin, grid->rootOrigin);
+
+      // Find all inner nodes first. This allows us to allocate buffers for all
+      // levels in one go, and to insert leaves in parallel (below).
+      const auto nodeKeys =
+          computeInnerNodeKeys(*topology, leafOffsets, leafLevel);
+      assert(nodeKeys[0].size() == 1);
+      allocateInnerLevels(*topology, nodeKeys, grid, bytesAllocated);
+      linkInnerNodes(*topology, nodeKeys, grid);
+
+      const range1f *pagedValueRange =
+          getDataPtr<range1f>(dataPagedValueRange.ptr);
+
+      std::vector<const void *> leafHeaders(numLeaves, nullptr);
+      const auto pagedNodes = createPagedLeaves(numLeaves,
+                                                leafFormat,
+                                                leafData,
+                                                pagedValueRange,
+                                                grid,
+                                                bytesAllocated,
+                                                leafHeaders);
+      if (!pagedNodes.empty() && !leafLoader)
+        runtimeError("leafLoader must be set if there are paged leaves");
+
+      createTemporalLeaves(*topology,
+                           numLeaves,
+                           leafLevel,
+                           leafFormat,
+                           leafData,
+                           temporalParams,
+                           grid,
+                           bytesAllocated,
+                           leafHeaders);
+
+      const auto collapsedLeaves = compactConstantLeaves(*topology,
+                                                         numLeaves,
+                                                         leafLevel,
+                                                         leafFormat,
+                                                         leafData,
+                                                         collapseUniformLeaves,
+                                                         deduplicateLeaves,
+                                                         leafHeaders);
+
+      const auto leafVoxelOffsets =
+          computeLeafVoxelOffsets(*topology, leafOffsets, leafLevel, nodeKeys);
+      checkDuplicateLeaves(
+          *topology, leafVoxelOffsets, leafOffsets, leafLevel, grid);
 
       // TODO: Support other types?
-      insertLeavesFloat(
-          leafOffsets, leafFormat, leafData, binnedLeaves, capacity, grid);
+      insertLeavesFloat(leafVoxelOffsets,
+                        leafOffsets,
+                        leafLevel,
+                        leafFormat,
+                        leafData,
+                        leafHeaders,
+                        collapsedLeaves,
+                        grid);
+
+      // Auxiliary data is only stored for active voxels, so we need the
+      // final tree structure first.
+      computeActiveMasks(*topology, grid, bytesAllocated);
+      computeLeafIndex(
+          *topology, leafVoxelOffsets, leafLevel, grid, bytesAllocated);
+      const auto ranges = computeValueRanges(*topology,
+                                             leafVoxelOffsets,
+                                             leafLevel,
+                                             leafFormat,
+                                             leafData,
+                                             pagedValueRange,
+                                             nodeKeys,
+                                             grid);
+      // Iterators need ranges that bound filtered samples.
+      storeValueRanges(
+          computeFilterValueRanges(*topology, nodeKeys, grid, ranges, filter),
+          grid,
+          bytesAllocated);
+      computeMeans(*topology,
+                   leafVoxelOffsets,
+                   leafLevel,
+                   leafFormat,
+                   leafData,
+                   pagedValueRange,
+                   nodeKeys,
+                   grid,
+                   bytesAllocated);
+
+      grid->maxVoxelOffset = computeMaxVoxelOffset(*topology, grid);
+
+      // Iterators store 32 bit node indices (see VdbIterator).
+      for (uint32_t l = 0; l + 1 < topology->numLevels; ++l) {
+        if (grid->levels[l].numNodes > std::numeric_limits<uint32_t>::max())
+          runtimeError("too many nodes on level ", l);
+      }
 
+      // The volume value range is exact, even though the grid stores
+      // rounded ranges.
       valueRange = range1f();
-      for (size_t i = 0; i < vklVdbLevelNumVoxels(0); ++i)
-        valueRange.extend(grid->levels[0].valueRange[i]);
-
-      CALL_ISPC(VdbVolume_setGrid,
-                Volume<W>::getISPCEquivalent(),
-                reinterpret_cast<ispc::VdbGrid *>(grid));
+      for (const range1f &r : ranges[0])
+        valueRange.extend(r);
+
+      // From here on, the volume uses the sampler compiled for its topology.
+      topology->setGrid(Volume<W>::getISPCEquivalent(), grid);
+
+      if (!pagedNodes.empty()) {
+        std::vector<uint32_t> pagedLevels(pagedNodes.size());
+        for (size_t i = 0; i < pagedNodes.size(); ++i)
+          pagedLevels[i] = leafLevel[pagedNodes[i]];
+
+        leafCache.reset(new VdbLeafCache(*topology,
+                                         leafLoader,
+                                         leafLoaderUserData,
+                                         grid->pagedLeaves,
+                                         pagedNodes,
+                                         std::move(pagedLevels),
+                                         maxResidentLeaves,
+                                         waitForLeafLoads));
+      }
     }
 
     template <int W>
@@ -547,21 +1856,93 @@ namespace openvkl {
                                       const vvec3fn<W> &objectCoordinates,
                                       vfloatn<W> &samples) const
     {
-      CALL_ISPC(VdbSampler_computeSample,
-                static_cast<const int *>(valid),
-                this->ispcEquivalent,
-                &objectCoordinates,
-                static_cast<float *>(samples));
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      topology->computeSample(static_cast<const int *>(valid),
+                              this->ispcEquivalent,
+                              &objectCoordinates,
+                              nullptr,
+                              nullptr,
+                              static_cast<float *>(samples));
+    }
+
+    template <int W>
+    void VdbVolume<W>::computeGradientV(const vintn<W> &valid,
+                                        const vvec3fn<W> &objectCoordinates,
+                                        vvec3fn<W> &gradients) const
+    {
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      topology->computeGradient(static_cast<const int *>(valid),
+                                this->ispcEquivalent,
+                                &objectCoordinates,
+                                &gradients);
+    }
+
+    template <int W>
+    void VdbVolume<W>::computeSampleTimeV(const vintn<W> &valid,
+                                          const vvec3fn<W> &objectCoordinates,
+                                          const vfloatn<W> &times,
+                                          vfloatn<W> &samples) const
+    {
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      topology->computeSample(static_cast<const int *>(valid),
+                              this->ispcEquivalent,
+                              &objectCoordinates,
+                              static_cast<const float *>(times),
+                              nullptr,
+                              static_cast<float *>(samples));
     }
 
     template <int W>
     void VdbVolume<W>::computeSample(const vvec3fn<1> &objectCoordinates,
                                      vfloatn<1> &samples) const
     {
-      CALL_ISPC(VdbSampler_computeSample_uniform,
-                this->ispcEquivalent,
-                &objectCoordinates,
-                static_cast<float *>(samples));
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      topology->computeSampleUniform(this->ispcEquivalent,
+                                     &objectCoordinates,
+                                     nullptr,
+                                     nullptr,
+                                     static_cast<float *>(samples));
+    }
+
+    template <int W>
+    void VdbVolume<W>::computeSampleTime(const vvec3fn<1> &objectCoordinates,
+                                         float time,
+                                         vfloatn<1> &samples) const
+    {
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      topology->computeSampleUniform(this->ispcEquivalent,
+                                     &objectCoordinates,
+                                     &time,
+                                     nullptr,
+                                     static_cast<float *>(samples));
+    }
+
+    template <int W>
+    void VdbVolume<W>::computeSampleLodV(const vintn<W> &valid,
+                                         const vvec3fn<W> &objectCoordinates,
+                                         const vfloatn<W> &lods,
+                                         vfloatn<W> &samples) const
+    {
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      topology->computeSample(static_cast<const int *>(valid),
+                              this->ispcEquivalent,
+                              &objectCoordinates,
+                              nullptr,
+                              static_cast<const float *>(lods),
+                              static_cast<float *>(samples));
+    }
+
+    template <int W>
+    void VdbVolume<W>::computeSampleLod(const vvec3fn<1> &objectCoordinates,
+                                        float lod,
+                                        vfloatn<1> &samples) const
+    {
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      topology->computeSampleUniform(this->ispcEquivalent,
+                                     &objectCoordinates,
+                                     nullptr,
+                                     &lod,
+                                     static_cast<float *>(samples));
     }
 
     template <int W>
@@ -574,11 +1955,22 @@ namespace openvkl {
 
       const std::string t(type);
       if (t == "LeafNodeAccess") {
-        if (!grid->usageBuffer)
-          grid->usageBuffer =
+        if (!grid->usageBuffer) {
+          // Other threads may be sampling. They write through the pointer
+          // they load, so the release store orders the zeroed buffer
+          // before these writes.
+          uint32 *usageBuffer =
               allocate<uint32>(grid->totalNumLeaves, bytesAllocated);
+          reinterpret_cast<std::atomic<uint32 *> &>(grid->usageBuffer)
+              .store(usageBuffer, std::memory_order_release);
+        }
         return (VKLObserver) new VdbLeafAccessObserver(
             *this, grid->totalNumLeaves, grid->usageBuffer);
+      } else if (t == "MemoryUsage") {
+        const size_t cacheBytes =
+            leafCache ? leafCache->getBytesAllocated() : 0;
+        return (VKLObserver) new MemoryUsageObserver(
+            *this, bytesAllocated + cacheBytes);
       } else {
         return Volume<W>::newObserver(type);
       }
@@ -593,8 +1985,15 @@ namespace openvkl {
         const vrange1fn<W> &tRange,
         const ValueSelector<W> *valueSelector)
     {
-      initVKLIntervalIterator<VdbIterator<W>>(
-          iterator, valid, this, origin, direction, tRange, valueSelector);
+      // Intervals do not depend on time.
+      initVKLIntervalIterator<VdbIterator<W>>(iterator,
+                                              valid,
+                                              this,
+                                              origin,
+                                              direction,
+                                              tRange,
+                                              nullptr,
+                                              valueSelector);
     }
 
     template <int W>
@@ -619,8 +2018,34 @@ namespace openvkl {
                                         const vrange1fn<W> &tRange,
                                         const ValueSelector<W> *valueSelector)
     {
-      initVKLHitIterator<DefaultIterator<W>>(
-          iterator, valid, this, origin, direction, tRange, valueSelector);
+      initVKLHitIterator<VdbIterator<W>>(iterator,
+                                         valid,
+                                         this,
+                                         origin,
+                                         direction,
+                                         tRange,
+                                         nullptr,
+                                         valueSelector);
+    }
+
+    template <int W>
+    void VdbVolume<W>::initHitIteratorTimeV(
+        const vintn<W> &valid,
+        vVKLHitIteratorN<W> &iterator,
+        const vvec3fn<W> &origin,
+        const vvec3fn<W> &direction,
+        const vrange1fn<W> &tRange,
+        const vfloatn<W> &times,
+        const ValueSelector<W> *valueSelector)
+    {
+      initVKLHitIterator<VdbIterator<W>>(iterator,
+                                         valid,
+                                         this,
+                                         origin,
+                                         direction,
+                                         tRange,
+                                         static_cast<const float *>(times),
+                                         valueSelector);
     }
 
     template <int W>
@@ -629,7 +2054,8 @@ namespace openvkl {
                                    vVKLHitN<W> &hit,
                                    vintn<W> &result)
     {
-      DefaultIterator<W> *i = fromVKLHitIterator<DefaultIterator<W>>(&iterator);
+      const VdbLeafCache::ReadGuard guard(leafCache.get());
+      VdbIterator<W> *i = fromVKLHitIterator<VdbIterator<W>>(&iterator);
 
       i->iterateHit(valid, result);
 
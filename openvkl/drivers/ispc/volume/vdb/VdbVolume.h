@@ -9,6 +9,8 @@
 #include "../common/Data.h"
 #include "VdbGrid.h"
 #include "VdbIterator.h"
+#include "VdbLeafCache.h"
+#include "VdbTopology.h"
 #include "VdbVolume_ispc.h"
 #include "ospcommon/memory/RefCount.h"
 
@@ -54,15 +56,41 @@ namespace openvkl {
                          vfloatn<1> &samples) const override;
 
       /*
-       * Compute the volume gradient at the given coordinates.
-       * NOT IMPLEMENTED.
+       * Sample the volume at the given coordinates and times. Leaves in
+       * the DENSE and TUV formats are interpolated in time; all other
+       * leaves are constant in time.
+       */
+      void computeSampleTimeV(const vintn<W> &valid,
+                              const vvec3fn<W> &objectCoordinates,
+                              const vfloatn<W> &times,
+                              vfloatn<W> &samples) const override;
+
+      void computeSampleTime(const vvec3fn<1> &objectCoordinates,
+                             float time,
+                             vfloatn<1> &samples) const override;
+
+      /*
+       * Sample the volume at the given level of detail. Traversal stops at
+       * the coarsest level whose voxels are not larger than the footprint,
+       * and returns the mean value of the voxel there.
+       */
+      void computeSampleLodV(const vintn<W> &valid,
+                             const vvec3fn<W> &objectCoordinates,
+                             const vfloatn<W> &lods,
+                             vfloatn<W> &samples) const override;
+
+      void computeSampleLod(const vvec3fn<1> &objectCoordinates,
+                            float lod,
+                            vfloatn<1> &samples) const override;
+
+      /*
+       * Compute the volume gradient at the given coordinates. Gradients
+       * are analytic for the tricubic filter, and forward differences
+       * otherwise.
        */
       void computeGradientV(const vintn<W> &valid,
                             const vvec3fn<W> &objectCoordinates,
-                            vvec3fn<W> &gradients) const override
-      {
-        THROW_NOT_IMPLEMENTED;
-      }
+                            vvec3fn<W> &gradients) const override;
 
       /*
        * Obtain the volume bounding box.
@@ -85,8 +113,27 @@ namespace openvkl {
         return grid;
       }
 
+      /*
+       * The topology selected on commit. Sampling and iteration call into
+       * the ISPC code compiled for this topology.
+       */
+      const VdbTopology &getTopology() const
+      {
+        return *topology;
+      }
+
       VKLObserver newObserver(const char *type) override;
 
+      size_t getIntervalIteratorSizeV() const override
+      {
+        return sizeof(VdbIterator<W>);
+      }
+
+      size_t getHitIteratorSizeV() const override
+      {
+        return sizeof(VdbIterator<W>);
+      }
+
       void initIntervalIteratorV(
           const vintn<W> &valid,
           vVKLIntervalIteratorN<W> &iterator,
@@ -107,6 +154,15 @@ namespace openvkl {
                             const vrange1fn<W> &tRange,
                             const ValueSelector<W> *valueSelector) override;
 
+      void initHitIteratorTimeV(
+          const vintn<W> &valid,
+          vVKLHitIteratorN<W> &iterator,
+          const vvec3fn<W> &origin,
+          const vvec3fn<W> &direction,
+          const vrange1fn<W> &tRange,
+          const vfloatn<W> &times,
+          const ValueSelector<W> *valueSelector) override;
+
       void iterateHitV(const vintn<W> &valid,
                        vVKLHitIteratorN<W> &iterator,
                        vVKLHitN<W> &hit,
@@ -122,6 +178,8 @@ namespace openvkl {
       Ref<Data> dataData;
       VdbGrid *grid{nullptr};
       size_t bytesAllocated{0};
+      std::unique_ptr<VdbLeafCache> leafCache;
+      const VdbTopology *topology{&getVdbTopology(0)};
     };
 
   }  // namespace ispc_driver
@@ -3,15 +3,16 @@
 
 #include <iostream>
 #include "VdbIterator.h"
-#include "VdbIterator_ispc.h"
+// The default topology. Iterator state does not depend on the topology.
+#include "VdbIterator_t0_ispc.h"
 #include "common/export_util.h"
 
 int main()
 {
   std::cout << "sizeof(ispc::VdbIterator<" << VKL_TARGET_WIDTH
-            << ">): " << CALL_ISPC(VdbIterator_sizeOf) << " B / "
+            << ">): " << CALL_ISPC(VdbIterator_sizeOf_t0) << " B / "
             << VKL_TARGET_WIDTH << " lanes = "
-            << CALL_ISPC(VdbIterator_sizeOf) /
+            << CALL_ISPC(VdbIterator_sizeOf_t0) /
                    static_cast<float>(VKL_TARGET_WIDTH)
             << " B / lane" << std::endl;
   std::cout << "sizeof(VdbIterator<" << VKL_TARGET_WIDTH << ">): "
@@ -0,0 +1,30 @@
+// Copyright 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#if __cplusplus >= 201103L
+#include <cstdint>
+#endif
+
+// this header is shared with ISPC
+
+// An enum that represents the different filter types available in structured
+// and VDB volumes.
+#if __cplusplus >= 201103L
+enum VKLFilter : uint32_t
+#else
+enum VKLFilter
+#endif
+{
+  // Only read the voxel the sample position is in, treating it as
+  // constant.
+  VKL_FILTER_NEAREST = 0,
+  // Read the eight voxels surrounding the sample position, and
+  // interpolate trilinearly.
+  VKL_FILTER_TRILINEAR = 100,
+  // Read the 4x4x4 voxels surrounding the sample position, and apply a
+  // cubic B-spline filter. This is smoother than trilinear interpolation,
+  // but does not interpolate the voxel values.
+  VKL_FILTER_TRICUBIC = 200,
+};
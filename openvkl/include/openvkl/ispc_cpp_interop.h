@@ -20,6 +20,7 @@
 
 // Unified integer typedefs.
 
+typedef unsigned int16 vkl_uint16;
 typedef unsigned int vkl_uint32;
 typedef int vkl_int32;
 typedef unsigned int64 vkl_uint64;
@@ -40,6 +41,7 @@ typedef unsigned int64 vkl_uint64;
 
 // Unified integer typedefs.
 
+typedef uint16_t vkl_uint16;
 typedef uint32_t vkl_uint32;
 typedef int32_t vkl_int32;
 typedef uint64_t vkl_uint64;
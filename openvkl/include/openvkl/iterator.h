@@ -18,30 +18,30 @@ extern "C" {
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE];
-  VKLVolume volume;
 } VKLIntervalIterator;
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT_4)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE_4];
-  VKLVolume volume;
 } VKLIntervalIterator4;
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT_8)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE_8];
-  VKLVolume volume;
 } VKLIntervalIterator8;
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT_16)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE_16];
-  VKLVolume volume;
 } VKLIntervalIterator16;
 
 typedef struct
@@ -49,6 +49,9 @@ typedef struct
   vkl_range1f tRange;
   vkl_range1f valueRange;
   float nominalDeltaT;
+  // Maximum of the value selector's transfer function over valueRange, or
+  // inf if the value selector has no transfer function.
+  float majorant;
 } VKLInterval;
 
 typedef struct
@@ -56,6 +59,7 @@ typedef struct
   vkl_vrange1f4 tRange;
   vkl_vrange1f4 valueRange;
   float nominalDeltaT[4];
+  float majorant[4];
 } VKLInterval4;
 
 typedef struct
@@ -63,6 +67,7 @@ typedef struct
   vkl_vrange1f8 tRange;
   vkl_vrange1f8 valueRange;
   float nominalDeltaT[8];
+  float majorant[8];
 } VKLInterval8;
 
 typedef struct
@@ -70,8 +75,25 @@ typedef struct
   vkl_vrange1f16 tRange;
   vkl_vrange1f16 valueRange;
   float nominalDeltaT[16];
+  float majorant[16];
 } VKLInterval16;
 
+// Returns the number of bytes an iterator of the given width needs for this
+// volume, which is at most sizeof(VKLIntervalIterator) for that width. Callers
+// may allocate a buffer of this size, aligned like VKLIntervalIterator, and
+// pass it to the iterator functions below through a pointer cast.
+OPENVKL_INTERFACE
+size_t vklGetIntervalIteratorSize(VKLVolume volume);
+
+OPENVKL_INTERFACE
+size_t vklGetIntervalIteratorSize4(VKLVolume volume);
+
+OPENVKL_INTERFACE
+size_t vklGetIntervalIteratorSize8(VKLVolume volume);
+
+OPENVKL_INTERFACE
+size_t vklGetIntervalIteratorSize16(VKLVolume volume);
+
 OPENVKL_INTERFACE
 void vklInitIntervalIterator(VKLIntervalIterator *iterator,
                              VKLVolume volume,
@@ -129,36 +151,78 @@ void vklIterateInterval16(const int *valid,
                           VKLInterval16 *interval,
                           int *result);
 
+// A compact snapshot of a scalar interval iterator, from which iteration can
+// resume later, e.g. after a ray was suspended in a wavefront renderer. t is
+// the ray parameter up to which the iterator has advanced; the cursor is a
+// volume type specific position, such as a cell index.
+typedef struct
+{
+  float t;
+  uint32_t cursor[4];
+} VKLIntervalIteratorCheckpoint;
+
+OPENVKL_INTERFACE
+void vklGetIntervalIteratorCheckpoint(
+    const VKLIntervalIterator *iterator,
+    VKLIntervalIteratorCheckpoint *checkpoint);
+
+// Initializes the iterator so that it continues where the checkpoint was
+// taken. The volume, ray, and value selector must be the same as those the
+// checkpointed iterator was initialized with.
+OPENVKL_INTERFACE
+void vklResumeIntervalIterator(VKLIntervalIterator *iterator,
+                               VKLVolume volume,
+                               const vkl_vec3f *origin,
+                               const vkl_vec3f *direction,
+                               const vkl_range1f *tRange,
+                               const VKLIntervalIteratorCheckpoint *checkpoint,
+                               VKLValueSelector valueSelector);
+
+// Iterates intervals for a batch of rays at once. Up to maxIntervalsPerRay
+// intervals of ray i are written to intervals[i * maxIntervalsPerRay], and
+// their number to numIntervals[i]. tRanges may be NULL to iterate along the
+// full rays.
+OPENVKL_INTERFACE
+void vklIterateIntervalStream(VKLVolume volume,
+                              size_t numRays,
+                              const vkl_vec3f *origins,
+                              const vkl_vec3f *directions,
+                              const vkl_range1f *tRanges,
+                              VKLValueSelector valueSelector,
+                              size_t maxIntervalsPerRay,
+                              VKLInterval *intervals,
+                              uint32_t *numIntervals);
+
 ///////////////////////////////////////////////////////////////////////////////
 // Hit iterators //////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE];
-  VKLVolume volume;
 } VKLHitIterator;
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT_4)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE_4];
-  VKLVolume volume;
 } VKLHitIterator4;
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT_8)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE_8];
-  VKLVolume volume;
 } VKLHitIterator8;
 
 typedef struct
 {
+  VKLVolume volume;
   VKL_ALIGN(ITERATOR_INTERNAL_STATE_ALIGNMENT_16)
   char internalState[ITERATOR_INTERNAL_STATE_SIZE_16];
-  VKLVolume volume;
 } VKLHitIterator16;
 
 typedef struct
@@ -185,6 +249,22 @@ typedef struct
   float sample[16];
 } VKLHit16;
 
+// Returns the number of bytes an iterator of the given width needs for this
+// volume, which is at most sizeof(VKLHitIterator) for that width. Callers
+// may allocate a buffer of this size, aligned like VKLHitIterator, and pass
+// it to the iterator functions below through a pointer cast.
+OPENVKL_INTERFACE
+size_t vklGetHitIteratorSize(VKLVolume volume);
+
+OPENVKL_INTERFACE
+size_t vklGetHitIteratorSize4(VKLVolume volume);
+
+OPENVKL_INTERFACE
+size_t vklGetHitIteratorSize8(VKLVolume volume);
+
+OPENVKL_INTERFACE
+size_t vklGetHitIteratorSize16(VKLVolume volume);
+
 OPENVKL_INTERFACE
 void vklInitHitIterator(VKLHitIterator *iterator,
                         VKLVolume volume,
@@ -220,6 +300,47 @@ void vklInitHitIterator16(const int *valid,
                           const vkl_vrange1f16 *tRange,
                           VKLValueSelector valueSelector);
 
+// Hit iterators on time-varying volumes, at the given time in [0, 1]. Volumes
+// that do not vary over time behave as with vklInitHitIterator().
+OPENVKL_INTERFACE
+void vklInitHitIteratorTime(VKLHitIterator *iterator,
+                            VKLVolume volume,
+                            const vkl_vec3f *origin,
+                            const vkl_vec3f *direction,
+                            const vkl_range1f *tRange,
+                            float time,
+                            VKLValueSelector valueSelector);
+
+OPENVKL_INTERFACE
+void vklInitHitIteratorTime4(const int *valid,
+                             VKLHitIterator4 *iterator,
+                             VKLVolume volume,
+                             const vkl_vvec3f4 *origin,
+                             const vkl_vvec3f4 *direction,
+                             const vkl_vrange1f4 *tRange,
+                             const float *times,
+                             VKLValueSelector valueSelector);
+
+OPENVKL_INTERFACE
+void vklInitHitIteratorTime8(const int *valid,
+                             VKLHitIterator8 *iterator,
+                             VKLVolume volume,
+                             const vkl_vvec3f8 *origin,
+                             const vkl_vvec3f8 *direction,
+                             const vkl_vrange1f8 *tRange,
+                             const float *times,
+                             VKLValueSelector valueSelector);
+
+OPENVKL_INTERFACE
+void vklInitHitIteratorTime16(const int *valid,
+                              VKLHitIterator16 *iterator,
+                              VKLVolume volume,
+                              const vkl_vvec3f16 *origin,
+                              const vkl_vvec3f16 *direction,
+                              const vkl_vrange1f16 *tRange,
+                              const float *times,
+                              VKLValueSelector valueSelector);
+
 // returns true while the iterator is still within the volume
 OPENVKL_INTERFACE
 int vklIterateHit(VKLHitIterator *iterator, VKLHit *hit);
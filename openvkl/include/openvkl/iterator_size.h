@@ -5,17 +5,20 @@
 
 // see SIMD conformance tests
 
+// The largest iterator is the VDB iterator. These sizes allow VDB topologies
+// with up to 6 levels.
+
 #define ITERATOR_INTERNAL_STATE_ALIGNMENT 64
-#define ITERATOR_INTERNAL_STATE_SIZE 6080
+#define ITERATOR_INTERNAL_STATE_SIZE 3456
 
 #define ITERATOR_INTERNAL_STATE_ALIGNMENT_4 16
-#define ITERATOR_INTERNAL_STATE_SIZE_4 1520
+#define ITERATOR_INTERNAL_STATE_SIZE_4 864
 
 #define ITERATOR_INTERNAL_STATE_ALIGNMENT_8 32
-#define ITERATOR_INTERNAL_STATE_SIZE_8 3040
+#define ITERATOR_INTERNAL_STATE_SIZE_8 1728
 
 #define ITERATOR_INTERNAL_STATE_ALIGNMENT_16 64
-#define ITERATOR_INTERNAL_STATE_SIZE_16 6080
+#define ITERATOR_INTERNAL_STATE_SIZE_16 3456
 
 #define ITERATOR_VARYING_INTERNAL_STATE_SIZE \
   ITERATOR_INTERNAL_STATE_SIZE_16 / 16 / 4
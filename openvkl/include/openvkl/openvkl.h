@@ -5,6 +5,7 @@
 
 #include "VKLDataType.h"
 #include "VKLError.h"
+#include "VKLFilter.h"
 #include "VKLLogLevel.h"
 
 #include "common.h"
@@ -32,6 +32,31 @@ void vklValueSelectorSetValues(VKLValueSelector valueSelector,
                                size_t numValues,
                                const float *values);
 
+// Set a piecewise linear opacity transfer function, with numOpacities values
+// evenly spaced over valueRange. Interval iterators using this value selector
+// return the maximum opacity over each interval in VKLInterval::majorant.
+OPENVKL_INTERFACE
+void vklValueSelectorSetTransferFunction(VKLValueSelector valueSelector,
+                                         const vkl_range1f *valueRange,
+                                         size_t numOpacities,
+                                         const float *opacities);
+
+// Cut away the inside of the given boxes from the volume. Iterators using
+// this value selector skip clipped regions, and never return intervals or hits
+// inside them. Clip boxes and clip planes may be combined; the clipped region
+// is the union of all of them.
+OPENVKL_INTERFACE
+void vklValueSelectorSetClipBoxes(VKLValueSelector valueSelector,
+                                  size_t numBoxes,
+                                  const vkl_box3f *boxes);
+
+// Cut away the positive half space of the given planes, each given as four
+// floats (a, b, c, d): points with a*x + b*y + c*z + d > 0 are clipped.
+OPENVKL_INTERFACE
+void vklValueSelectorSetClipPlanes(VKLValueSelector valueSelector,
+                                   size_t numPlanes,
+                                   const float *planes);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "VKLDataType.h"
+#include "VKLFilter.h"
 #include "ispc_cpp_interop.h"
 
 // ========================================================================== //
@@ -31,9 +32,17 @@
 //  __vkl_vdb_map_offset_to_voxel_<level>(univary, offset)
 //  __vkl_vdb_3d_to_linear_<level>(offx, offy, offz)
 //  __vkl_vdb_map_offset_to_lindex_<level>(offset_3d)
+//
+// These describe the default topology. The ISPC driver compiles its VDB code
+// for additional topologies, and defines VKL_VDB_TOPOLOGY_HEADER to select
+// the topology of the current translation unit.
 // ========================================================================== //
 //
+#if defined(VKL_VDB_TOPOLOGY_HEADER)
+#include VKL_VDB_TOPOLOGY_HEADER
+#else
 #include "openvkl/vdb/topology.h"  // This file is generated by cmake.
+#endif
 
 // ========================================================================== //
 // The following are runtime versions of the constants described above,
@@ -215,23 +224,6 @@ inline varying vkl_uint64 vklVdbDomainOffsetToLinear(varying vkl_uint32 level,
 
 #undef __vkl_vdb_switch_case
 
-// ========================================================================== //
-// An enum that represents the different filter types available in vdb volumes.
-// ========================================================================== //
-#if __cplusplus >= 201103L
-enum VKLFilter : vkl_uint32
-#else
-enum VKLFilter
-#endif
-{
-  // Only read the voxel the sample position is in, treating it as
-  // constant.
-  VKL_FILTER_NEAREST = 0,
-  // Read the eight voxels surrounding the sample position, and
-  // interpolate trilinearly.
-  VKL_FILTER_TRILINEAR = 100,
-};
-
 // ========================================================================== //
 // An enum for leaf data format constants.
 // This value determines how the leaf data buffer is interpreted by VKL
@@ -248,12 +240,31 @@ enum VKLVdbLeafFormat
   // The data is temporally constant, and the buffer contains an array of
   // vklVdbNumVoxels(level) values.
   VKL_VDB_FORMAT_CONSTANT,
-  // (unsupported) The data is temporally dense.
-  // TODO: Support this format.
+  // The data is temporally structured, with N time steps evenly spaced on
+  // [0, 1], where N is given per leaf in temporallyStructuredNumTimesteps.
+  // The buffer contains N * vklVdbNumVoxels(level) values, with all time
+  // steps of a voxel stored contiguously.
   VKL_VDB_FORMAT_DENSE,
-  // (unsupported) The data is temporally dense.
-  // The data is a temporally unstructured volume (TUV).
-  // TODO: Support this format.
+  // The data is a temporally unstructured volume (TUV): every voxel has its
+  // own, ascending set of times in [0, 1]. The buffer contains the values
+  // of all voxels. The values of voxel v are in the range
+  // [temporallyUnstructuredIndices[v], temporallyUnstructuredIndices[v+1]),
+  // and temporallyUnstructuredTimes holds one time per value.
   VKL_VDB_FORMAT_TUV,
   VKL_VDB_FORMAT_INVALID
 };
+
+#if !defined(ISPC)
+
+// ========================================================================== //
+// Loader for paged leaf nodes (see the leafLoader parameter of VDB volumes).
+// Must write vklVdbLevelNumVoxels(level) values for the input node with the
+// given index to buffer, and return nonzero on success.
+// Loaders are called from a background thread.
+// ========================================================================== //
+typedef int (*VKLVdbLeafLoader)(void *userData,
+                                vkl_uint64 nodeIndex,
+                                vkl_uint32 level,
+                                float *buffer);
+
+#endif  // !defined(ISPC)
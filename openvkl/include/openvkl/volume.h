@@ -74,6 +74,76 @@ void vklComputeSample16(const int *valid,
                         const vkl_vvec3f16 *objectCoordinates,
                         float *samples);
 
+// Sample time-varying volumes at the given time in [0, 1]. Volumes that do not
+// vary over time return the same values as vklComputeSample().
+OPENVKL_INTERFACE
+float vklComputeSampleTime(VKLVolume volume,
+                           const vkl_vec3f *objectCoordinates,
+                           float time);
+
+OPENVKL_INTERFACE
+void vklComputeSampleTime4(const int *valid,
+                           VKLVolume volume,
+                           const vkl_vvec3f4 *objectCoordinates,
+                           const float *times,
+                           float *samples);
+
+OPENVKL_INTERFACE
+void vklComputeSampleTime8(const int *valid,
+                           VKLVolume volume,
+                           const vkl_vvec3f8 *objectCoordinates,
+                           const float *times,
+                           float *samples);
+
+OPENVKL_INTERFACE
+void vklComputeSampleTime16(const int *valid,
+                            VKLVolume volume,
+                            const vkl_vvec3f16 *objectCoordinates,
+                            const float *times,
+                            float *samples);
+
+// Sample with a level of detail, given as the base-2 logarithm of the sample
+// footprint measured in the volume's finest voxels. Volumes that support level
+// of detail may return filtered values for lods > 0; other volumes return the
+// same values as vklComputeSample().
+OPENVKL_INTERFACE
+float vklComputeSampleLod(VKLVolume volume,
+                          const vkl_vec3f *objectCoordinates,
+                          float lod);
+
+OPENVKL_INTERFACE
+void vklComputeSampleLod4(const int *valid,
+                          VKLVolume volume,
+                          const vkl_vvec3f4 *objectCoordinates,
+                          const float *lods,
+                          float *samples);
+
+OPENVKL_INTERFACE
+void vklComputeSampleLod8(const int *valid,
+                          VKLVolume volume,
+                          const vkl_vvec3f8 *objectCoordinates,
+                          const float *lods,
+                          float *samples);
+
+OPENVKL_INTERFACE
+void vklComputeSampleLod16(const int *valid,
+                           VKLVolume volume,
+                           const vkl_vvec3f16 *objectCoordinates,
+                           const float *lods,
+                           float *samples);
+
+// Sample the volume at numSamples points along a ray, at t = t0 + i * dt. The
+// samples are the same as from vklComputeSample() at the corresponding points,
+// but the ray is set up once for all samples.
+OPENVKL_INTERFACE
+void vklSampleRay(VKLVolume volume,
+                  const vkl_vec3f *origin,
+                  const vkl_vec3f *direction,
+                  float t0,
+                  float dt,
+                  unsigned int numSamples,
+                  float *samples);
+
 OPENVKL_INTERFACE
 vkl_vec3f vklComputeGradient(VKLVolume volume,
                              const vkl_vec3f *objectCoordinates);
@@ -99,6 +169,12 @@ void vklComputeGradient16(const int *valid,
 OPENVKL_INTERFACE
 vkl_box3f vklGetBoundingBox(VKLVolume volume);
 
+// Returns a box that contains all volume values other than zero. It may be
+// much smaller than the bounding box for volumes that are mostly empty, and is
+// the bounding box for volumes that do not track empty space.
+OPENVKL_INTERFACE
+vkl_box3f vklGetActiveBoundingBox(VKLVolume volume);
+
 OPENVKL_INTERFACE vkl_range1f vklGetValueRange(VKLVolume volume);
 
 #ifdef __cplusplus
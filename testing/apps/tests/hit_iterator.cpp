@@ -1,21 +1,71 @@
 // Copyright 2019 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
 #include "../../external/catch.hpp"
 #include "openvkl_testing.h"
 
 using namespace ospcommon;
 using namespace openvkl::testing;
 
-void scalar_hit_iteration(VKLVolume volume, const std::vector<float> &isoValues)
+void scalar_hit_iteration(VKLVolume volume,
+                          const std::vector<float> &isoValues,
+                          const vkl_vec3f &origin = {0.5f, 0.5f, -1.f})
+{
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, inf};
+
+  VKLValueSelector valueSelector = vklNewValueSelector(volume);
+
+  vklValueSelectorSetValues(valueSelector, isoValues.size(), isoValues.data());
+
+  vklCommit(valueSelector);
+
+  VKLHitIterator iterator;
+  vklInitHitIterator(
+      &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+  // hits are ordered by t, and duplicate values give a single hit
+  std::vector<float> expectedValues(isoValues);
+  std::sort(expectedValues.begin(), expectedValues.end());
+  expectedValues.erase(
+      std::unique(expectedValues.begin(), expectedValues.end()),
+      expectedValues.end());
+
+  VKLHit hit;
+
+  int hitCount = 0;
+
+  while (vklIterateHit(&iterator, &hit)) {
+    INFO("hit t = " << hit.t << ", sample = " << hit.sample);
+
+    REQUIRE(hitCount < expectedValues.size());
+    REQUIRE(hit.t == Approx(1.f + expectedValues[hitCount]));
+    REQUIRE(hit.sample == expectedValues[hitCount]);
+
+    hitCount++;
+  }
+
+  REQUIRE(hitCount == expectedValues.size());
+}
+
+// Clipping away a slab of the volume removes the hits inside of it.
+void scalar_hit_iteration_clipping(VKLVolume volume,
+                                   const std::vector<float> &isoValues)
 {
   vkl_vec3f origin{0.5f, 0.5f, -1.f};
   vkl_vec3f direction{0.f, 0.f, 1.f};
   vkl_range1f tRange{0.f, inf};
 
+  const vkl_box3f clipBox{{-1.f, -1.f, 0.35f}, {2.f, 2.f, 0.65f}};
+
   VKLValueSelector valueSelector = vklNewValueSelector(volume);
 
   vklValueSelectorSetValues(valueSelector, isoValues.size(), isoValues.data());
+  vklValueSelectorSetClipBoxes(valueSelector, 1, &clipBox);
 
   vklCommit(valueSelector);
 
@@ -23,6 +73,15 @@ void scalar_hit_iteration(VKLVolume volume, const std::vector<float> &isoValues)
   vklInitHitIterator(
       &iterator, volume, &origin, &direction, &tRange, valueSelector);
 
+  std::vector<float> expectedValues;
+  std::copy_if(isoValues.begin(),
+               isoValues.end(),
+               std::back_inserter(expectedValues),
+               [&](float v) {
+                 return v < clipBox.lower.z || v > clipBox.upper.z;
+               });
+  std::sort(expectedValues.begin(), expectedValues.end());
+
   VKLHit hit;
 
   int hitCount = 0;
@@ -30,13 +89,61 @@ void scalar_hit_iteration(VKLVolume volume, const std::vector<float> &isoValues)
   while (vklIterateHit(&iterator, &hit)) {
     INFO("hit t = " << hit.t << ", sample = " << hit.sample);
 
-    REQUIRE(hit.t == Approx(1.f + isoValues[hitCount]));
-    REQUIRE(hit.sample == isoValues[hitCount]);
+    REQUIRE(hitCount < expectedValues.size());
+    REQUIRE(hit.t == Approx(1.f + expectedValues[hitCount]));
+    REQUIRE(hit.sample == expectedValues[hitCount]);
 
     hitCount++;
   }
 
-  REQUIRE(hitCount == isoValues.size());
+  REQUIRE(hitCount == expectedValues.size());
+
+  vklRelease(valueSelector);
+}
+
+// A single cell with the saddle-shaped interpolant f = x * (1 - y). Along a
+// diagonal ray in the xy plane, f = s * (1 - s) is a hump that crosses
+// isovalues below 0.25 twice, close enough together to fall between two
+// stepping samples.
+std::vector<float> saddle_hits(bool exactHits, float isoValue)
+{
+  std::vector<float> voxels(8, 0.f);
+  voxels[1] = 1.f;  // x = 1, y = 0
+  voxels[5] = 1.f;
+
+  VKLVolume volume = vklNewVolume("structuredRegular");
+  vklSetVec3i(volume, "dimensions", 2, 2, 2);
+  VKLData data = vklNewData(voxels.size(), VKL_FLOAT, voxels.data());
+  vklSetData(volume, "data", data);
+  vklRelease(data);
+  vklSetBool(volume, "exactHits", exactHits);
+  vklCommit(volume);
+
+  // s = t / sqrt(2) - 1 on the ray
+  vkl_vec3f origin{-1.f, -1.f, 0.5f};
+  vkl_vec3f direction{1.f / std::sqrt(2.f), 1.f / std::sqrt(2.f), 0.f};
+  vkl_range1f tRange{0.f, inf};
+
+  VKLValueSelector valueSelector = vklNewValueSelector(volume);
+  vklValueSelectorSetValues(valueSelector, 1, &isoValue);
+  vklCommit(valueSelector);
+
+  VKLHitIterator iterator;
+  vklInitHitIterator(
+      &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+  std::vector<float> hits;
+  VKLHit hit;
+  while (vklIterateHit(&iterator, &hit)) {
+    REQUIRE(hit.sample == isoValue);
+    REQUIRE(hits.size() < 2);
+    hits.push_back(hit.t);
+  }
+
+  vklRelease(valueSelector);
+  vklRelease(volume);
+
+  return hits;
 }
 
 TEST_CASE("Hit iterator", "[hit_iterators]")
@@ -59,6 +166,16 @@ TEST_CASE("Hit iterator", "[hit_iterators]")
     defaultIsoValues.push_back(f);
   }
 
+  // many isovalues, unsorted and with duplicates
+  std::vector<float> manyIsoValues;
+
+  for (int i = 0; i < 100; i++) {
+    manyIsoValues.push_back((i + 0.5f) / 100.f);
+    manyIsoValues.push_back((i + 0.5f) / 100.f);
+  }
+
+  std::shuffle(manyIsoValues.begin(), manyIsoValues.end(), std::mt19937(0));
+
   SECTION("scalar hit iteration")
   {
     SECTION("structured volumes")
@@ -71,6 +188,16 @@ TEST_CASE("Hit iterator", "[hit_iterators]")
       scalar_hit_iteration(vklVolume, defaultIsoValues);
     }
 
+    SECTION("structured volumes: many unsorted isovalues")
+    {
+      std::unique_ptr<ZProceduralVolume> v(
+          new ZProceduralVolume(dimensions, gridOrigin, gridSpacing));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      scalar_hit_iteration(vklVolume, manyIsoValues);
+    }
+
     SECTION(
         "structured volumes: isovalues at grid accelerator macrocell "
         "boundaries")
@@ -90,6 +217,68 @@ TEST_CASE("Hit iterator", "[hit_iterators]")
       scalar_hit_iteration(vklVolume, macroCellBoundaries);
     }
 
+    SECTION("structured volumes: exact hits")
+    {
+      std::unique_ptr<ZProceduralVolume> v(
+          new ZProceduralVolume(dimensions, gridOrigin, gridSpacing));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      vklSetBool(vklVolume, "exactHits", true);
+      vklCommit(vklVolume);
+
+      scalar_hit_iteration(vklVolume, defaultIsoValues);
+      scalar_hit_iteration(vklVolume, manyIsoValues);
+    }
+
+    SECTION(
+        "structured volumes: exact hits at grid accelerator macrocell "
+        "boundaries")
+    {
+      std::unique_ptr<ZProceduralVolume> v(
+          new ZProceduralVolume(vec3i(128), vec3f(0.f), vec3f(1.f)));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      vklSetBool(vklVolume, "exactHits", true);
+      vklCommit(vklVolume);
+
+      std::vector<float> macroCellBoundaries;
+
+      for (int i = 0; i < 128; i += 16) {
+        macroCellBoundaries.push_back(float(i));
+      }
+
+      scalar_hit_iteration(vklVolume, macroCellBoundaries);
+    }
+
+    SECTION("structured volumes: exact hits in a saddle cell")
+    {
+      // stepping samples the ray every half voxel, at s = 0.414 and 0.768
+      // around the hump, and misses both crossings
+      const float isoValue = 0.245f;
+      CHECK(saddle_hits(false, isoValue).empty());
+
+      const std::vector<float> hits = saddle_hits(true, isoValue);
+      REQUIRE(hits.size() == 2);
+
+      const float d = std::sqrt(1.f - 4.f * isoValue);
+      CHECK(hits[0] ==
+            Approx(std::sqrt(2.f) * (1.f + 0.5f * (1.f - d))).margin(1e-4f));
+      CHECK(hits[1] ==
+            Approx(std::sqrt(2.f) * (1.f + 0.5f * (1.f + d))).margin(1e-4f));
+    }
+
+    SECTION("structured volumes: clipping")
+    {
+      std::unique_ptr<ZProceduralVolume> v(
+          new ZProceduralVolume(dimensions, gridOrigin, gridSpacing));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      scalar_hit_iteration_clipping(vklVolume, defaultIsoValues);
+    }
+
     SECTION("unstructured volumes")
     {
       std::unique_ptr<ZUnstructuredProceduralVolume> v(
@@ -100,5 +289,72 @@ TEST_CASE("Hit iterator", "[hit_iterators]")
 
       scalar_hit_iteration(vklVolume, defaultIsoValues);
     }
+
+    SECTION("vdb volumes")
+    {
+      std::unique_ptr<ZVdbVolume> v(
+          new ZVdbVolume(dimensions, gridOrigin, gridSpacing));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      scalar_hit_iteration(vklVolume, defaultIsoValues);
+    }
+
+    SECTION("vdb volumes: isovalues in leaf seams")
+    {
+      // leaves are 8**3; trilinear samples in the last voxel of a leaf
+      // interpolate with the first voxel of the next leaf
+      std::unique_ptr<ZVdbVolume> v(
+          new ZVdbVolume(vec3i(128), vec3f(0.f), vec3f(1.f)));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      std::vector<float> leafSeams;
+
+      for (int i = 8; i < 128; i += 8) {
+        leafSeams.push_back(i - 0.5f);
+      }
+
+      scalar_hit_iteration(vklVolume, leafSeams);
+    }
+
+    SECTION("vdb volumes: isovalues in leaf seams, tricubic filter")
+    {
+      // the B-spline stencil reaches one voxel below and two above the
+      // sample position; it reproduces the ramp away from the volume faces
+      std::unique_ptr<ZVdbVolume> v(new ZVdbVolume(
+          vec3i(128), vec3f(0.f), vec3f(1.f), VKL_FILTER_TRICUBIC));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      std::vector<float> leafSeams;
+
+      for (int i = 8; i < 120; i += 8) {
+        leafSeams.push_back(i - 0.5f);
+        leafSeams.push_back(i + 0.25f);
+      }
+
+      scalar_hit_iteration(vklVolume, leafSeams, {64.5f, 64.5f, -1.f});
+    }
+
+    SECTION("vdb volumes: clipping")
+    {
+      std::unique_ptr<ZVdbVolume> v(
+          new ZVdbVolume(dimensions, gridOrigin, gridSpacing));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      scalar_hit_iteration_clipping(vklVolume, defaultIsoValues);
+    }
+
+    SECTION("vdb volumes: many unsorted isovalues")
+    {
+      std::unique_ptr<ZVdbVolume> v(
+          new ZVdbVolume(dimensions, gridOrigin, gridSpacing));
+
+      VKLVolume vklVolume = v->getVKLVolume();
+
+      scalar_hit_iteration(vklVolume, manyIsoValues);
+    }
   }
 }
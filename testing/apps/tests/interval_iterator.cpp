@@ -5,6 +5,7 @@
 #include "iterator_utility.h"
 #include "openvkl_testing.h"
 #include "ospcommon/math/box.h"
+#include "ospcommon/memory/malloc.h"
 
 using namespace ospcommon;
 using namespace openvkl::testing;
@@ -169,6 +170,396 @@ void scalar_interval_value_ranges_with_value_selector(VKLVolume volume)
   vklRelease(valueSelector);
 }
 
+// Returns the piecewise linear transfer function at value, clamped outside
+// of valueRange.
+float evaluateOpacity(const range1f &valueRange,
+                      const std::vector<float> &opacities,
+                      float value)
+{
+  const float x = clamp((value - valueRange.lower) /
+                            (valueRange.upper - valueRange.lower) *
+                            (opacities.size() - 1.f),
+                        0.f,
+                        opacities.size() - 1.f);
+  const int i   = std::min(int(x), int(opacities.size()) - 2);
+  const float f = x - i;
+  return (1.f - f) * opacities[i] + f * opacities[i + 1];
+}
+
+void scalar_interval_majorants(VKLVolume volume)
+{
+  vkl_vec3f origin{0.5f, 0.5f, -1.f};
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, inf};
+
+  const vkl_range1f vklValueRange = vklGetValueRange(volume);
+  const range1f valueRange        = (const range1f &)vklValueRange;
+
+  const std::vector<float> opacities{0.f, 1.f, 0.25f, 0.f, 0.5f};
+
+  VKLValueSelector valueSelector = vklNewValueSelector(volume);
+  vklValueSelectorSetRanges(valueSelector, 1, &vklValueRange);
+
+  // no transfer function yet
+  vklCommit(valueSelector);
+
+  VKLIntervalIterator iterator;
+  vklInitIntervalIterator(
+      &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+  VKLInterval interval;
+
+  while (vklIterateInterval(&iterator, &interval)) {
+    REQUIRE(interval.majorant == inf);
+  }
+
+  vklValueSelectorSetTransferFunction(
+      valueSelector, &vklValueRange, opacities.size(), opacities.data());
+  vklCommit(valueSelector);
+
+  vklInitIntervalIterator(
+      &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+  int intervalCount = 0;
+
+  while (vklIterateInterval(&iterator, &interval)) {
+    INFO("interval valueRange = " << interval.valueRange.lower << ", "
+                                  << interval.valueRange.upper);
+
+    // the maximum over the value range is at an end point or table entry
+    float expectedMajorant =
+        std::max(evaluateOpacity(
+                     valueRange, opacities, interval.valueRange.lower),
+                 evaluateOpacity(
+                     valueRange, opacities, interval.valueRange.upper));
+
+    for (size_t i = 0; i < opacities.size(); i++) {
+      const float value = valueRange.lower + i * (valueRange.upper -
+                                                  valueRange.lower) /
+                                                 (opacities.size() - 1);
+      if (interval.valueRange.lower <= value &&
+          value <= interval.valueRange.upper) {
+        expectedMajorant = std::max(expectedMajorant, opacities[i]);
+      }
+    }
+
+    REQUIRE(interval.majorant == Approx(expectedMajorant));
+
+    // the majorant bounds the opacity of all samples in the interval; the
+    // transfer function is not monotonic, so we check every sample
+    constexpr int numSamples = 100;
+
+    for (int i = 0; i < numSamples; i++) {
+      const float t = interval.tRange.lower +
+                      float(i) / float(numSamples - 1) *
+                          (interval.tRange.upper - interval.tRange.lower);
+
+      const vkl_vec3f c{origin.x + t * direction.x,
+                        origin.y + t * direction.y,
+                        origin.z + t * direction.z};
+
+      const float sample = vklComputeSample(volume, &c);
+
+      INFO("t = " << t << ", sample = " << sample);
+      REQUIRE(evaluateOpacity(valueRange, opacities, sample) <=
+              interval.majorant + 1e-6f);
+    }
+
+    intervalCount++;
+  }
+
+  REQUIRE(intervalCount > 0);
+
+  vklRelease(valueSelector);
+}
+
+void scalar_interval_iterator_size(VKLVolume volume)
+{
+  const size_t iteratorSize = vklGetIntervalIteratorSize(volume);
+
+  REQUIRE(iteratorSize > 0);
+  REQUIRE(iteratorSize <= sizeof(VKLIntervalIterator));
+  REQUIRE(iteratorSize % alignof(VKLIntervalIterator) == 0);
+
+  vkl_vec3f origin{0.5f, 0.5f, -1.f};
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, inf};
+
+  VKLIntervalIterator iterator;
+  vklInitIntervalIterator(
+      &iterator, volume, &origin, &direction, &tRange, nullptr);
+
+  // an iterator in a buffer of exactly the queried size
+  void *buffer =
+      memory::alignedMalloc(iteratorSize, alignof(VKLIntervalIterator));
+  VKLIntervalIterator *smallIterator =
+      reinterpret_cast<VKLIntervalIterator *>(buffer);
+  vklInitIntervalIterator(
+      smallIterator, volume, &origin, &direction, &tRange, nullptr);
+
+  VKLInterval interval, smallInterval;
+
+  int intervalCount = 0;
+
+  while (true) {
+    const int result      = vklIterateInterval(&iterator, &interval);
+    const int smallResult = vklIterateInterval(smallIterator, &smallInterval);
+
+    REQUIRE(result == smallResult);
+
+    if (!result)
+      break;
+
+    REQUIRE(interval.tRange.lower == smallInterval.tRange.lower);
+    REQUIRE(interval.tRange.upper == smallInterval.tRange.upper);
+    REQUIRE(interval.valueRange.lower == smallInterval.valueRange.lower);
+    REQUIRE(interval.valueRange.upper == smallInterval.valueRange.upper);
+
+    intervalCount++;
+  }
+
+  REQUIRE(intervalCount > 0);
+
+  memory::alignedFree(buffer);
+}
+
+void scalar_interval_checkpoints(VKLVolume volume,
+                                 VKLValueSelector valueSelector = nullptr)
+{
+  vkl_vec3f origin{0.5f, 0.5f, -1.f};
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, inf};
+
+  std::vector<VKLInterval> intervals;
+
+  VKLIntervalIterator iterator;
+  vklInitIntervalIterator(
+      &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+  VKLInterval interval;
+  while (vklIterateInterval(&iterator, &interval))
+    intervals.push_back(interval);
+
+  REQUIRE(intervals.size() > 0);
+
+  // suspend after each interval, and resume on a different iterator
+  for (size_t i = 0; i <= intervals.size(); i++) {
+    INFO("suspended after " << i << " intervals");
+
+    vklInitIntervalIterator(
+        &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+    for (size_t j = 0; j < i; j++)
+      REQUIRE(vklIterateInterval(&iterator, &interval));
+
+    VKLIntervalIteratorCheckpoint checkpoint;
+    vklGetIntervalIteratorCheckpoint(&iterator, &checkpoint);
+
+    if (i > 0) {
+      REQUIRE(checkpoint.t >= intervals[i - 1].tRange.upper);
+    }
+
+    VKLIntervalIterator resumedIterator;
+    vklResumeIntervalIterator(&resumedIterator,
+                              volume,
+                              &origin,
+                              &direction,
+                              &tRange,
+                              &checkpoint,
+                              valueSelector);
+
+    for (size_t j = i; j < intervals.size(); j++) {
+      REQUIRE(vklIterateInterval(&resumedIterator, &interval));
+      REQUIRE(interval.tRange.lower == Approx(intervals[j].tRange.lower));
+      REQUIRE(interval.tRange.upper == Approx(intervals[j].tRange.upper));
+      REQUIRE(interval.valueRange.lower == intervals[j].valueRange.lower);
+      REQUIRE(interval.valueRange.upper == intervals[j].valueRange.upper);
+    }
+
+    REQUIRE(!vklIterateInterval(&resumedIterator, &interval));
+  }
+}
+
+// Iterates a ray through the unit cube with parts of it clipped away, and
+// checks that no intervals are returned in the clipped parts. Iterators that
+// split intervals at clip boundaries must cover exactly the visible parts;
+// others may return intervals spanning gaps between them.
+void scalar_interval_clipping(VKLVolume volume, bool splitsIntervals)
+{
+  vkl_vec3f origin{0.5f, 0.5f, -1.f};
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, inf};
+
+  // two overlapping boxes clip z in [0.3, 0.6], and a plane clips z > 0.8
+  const std::vector<vkl_box3f> clipBoxes{
+      {{-1.f, -1.f, 0.3f}, {2.f, 2.f, 0.5f}},
+      {{-1.f, -1.f, 0.45f}, {2.f, 2.f, 0.6f}}};
+  const std::vector<float> clipPlanes{0.f, 0.f, 1.f, -0.8f};
+
+  const std::vector<range1f> visibleTRanges{range1f(1.f, 1.3f),
+                                            range1f(1.6f, 1.8f)};
+
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+
+  // selectors that only clip select all values
+  for (bool withRanges : {true, false}) {
+    INFO("value selector with ranges = " << withRanges);
+
+    VKLValueSelector valueSelector = vklNewValueSelector(volume);
+    if (withRanges) {
+      vklValueSelectorSetRanges(valueSelector, 1, &valueRange);
+    }
+    vklValueSelectorSetClipBoxes(
+        valueSelector, clipBoxes.size(), clipBoxes.data());
+    vklValueSelectorSetClipPlanes(valueSelector, 1, clipPlanes.data());
+    vklCommit(valueSelector);
+
+    VKLIntervalIterator iterator;
+    vklInitIntervalIterator(
+        &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+    const float epsilon = 1e-4f;
+
+    VKLInterval interval;
+    float coveredLength = 0.f;
+    int intervalCount   = 0;
+
+    while (vklIterateInterval(&iterator, &interval)) {
+      INFO("interval tRange = " << interval.tRange.lower << ", "
+                                << interval.tRange.upper);
+
+      // intervals start and end in visible parts
+      REQUIRE(interval.tRange.lower >= visibleTRanges.front().lower - epsilon);
+      REQUIRE(interval.tRange.upper <= visibleTRanges.back().upper + epsilon);
+
+      bool insideVisible = false;
+      for (const range1f &r : visibleTRanges) {
+        if (interval.tRange.lower >= r.lower - epsilon &&
+            interval.tRange.upper <= r.upper + epsilon) {
+          insideVisible = true;
+        }
+      }
+
+      if (splitsIntervals) {
+        REQUIRE(insideVisible);
+      }
+
+      coveredLength += interval.tRange.upper - interval.tRange.lower;
+      intervalCount++;
+    }
+
+    REQUIRE(intervalCount > 0);
+
+    if (splitsIntervals) {
+      REQUIRE(coveredLength == Approx(0.5f).margin(1e-3f));
+    }
+
+    vklRelease(valueSelector);
+  }
+}
+
+void interval_stream(VKLVolume volume)
+{
+  const vkl_box3f bbox = vklGetBoundingBox(volume);
+  const vec3f lower(bbox.lower.x, bbox.lower.y, bbox.lower.z);
+  const vec3f extent =
+      vec3f(bbox.upper.x, bbox.upper.y, bbox.upper.z) - lower;
+
+  // Rays in both directions along z and along a diagonal, over a grid of
+  // origins that extends beyond the bounding box, so that some rays miss.
+  const std::vector<vec3f> rayDirections = {
+      vec3f(0.f, 0.f, 1.f), vec3f(0.f, 0.f, -1.f), normalize(vec3f(1.f))};
+
+  std::vector<vkl_vec3f> origins;
+  std::vector<vkl_vec3f> directions;
+
+  const int n = 9;
+  for (const vec3f &d : rayDirections) {
+    for (int y = 0; y < n; y++) {
+      for (int x = 0; x < n; x++) {
+        const vec3f o = lower +
+                        extent * vec3f((x - 1) / float(n - 3),
+                                       (y - 1) / float(n - 3),
+                                       0.5f) -
+                        2.f * reduce_max(extent) * d;
+        origins.push_back(vkl_vec3f{o.x, o.y, o.z});
+        directions.push_back(vkl_vec3f{d.x, d.y, d.z});
+      }
+    }
+  }
+
+  const size_t numRays = origins.size();
+
+  // a value selector for the middle half of the value range; culling
+  // differs between lanes
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+
+  const float quarter = 0.25f * (valueRange.upper - valueRange.lower);
+  const vkl_range1f selectedRange{valueRange.lower + quarter,
+                                  valueRange.upper - quarter};
+
+  VKLValueSelector rangeSelector = vklNewValueSelector(volume);
+  vklValueSelectorSetRanges(rangeSelector, 1, &selectedRange);
+  vklCommit(rangeSelector);
+
+  for (VKLValueSelector valueSelector :
+       {VKLValueSelector(nullptr), rangeSelector}) {
+    INFO("value selector = " << (valueSelector ? "middle half" : "none"));
+
+    for (size_t maxIntervals : {size_t(2), size_t(1024)}) {
+      INFO("maxIntervalsPerRay = " << maxIntervals);
+
+      std::vector<VKLInterval> intervals(numRays * maxIntervals);
+      std::vector<uint32_t> numIntervals(numRays);
+
+      vklIterateIntervalStream(volume,
+                               numRays,
+                               origins.data(),
+                               directions.data(),
+                               nullptr,
+                               valueSelector,
+                               maxIntervals,
+                               intervals.data(),
+                               numIntervals.data());
+
+      size_t numHits = 0;
+
+      for (size_t i = 0; i < numRays; i++) {
+        INFO("ray " << i);
+
+        vkl_range1f tRange{0.f, inf};
+        VKLIntervalIterator iterator;
+        vklInitIntervalIterator(&iterator,
+                                volume,
+                                &origins[i],
+                                &directions[i],
+                                &tRange,
+                                valueSelector);
+
+        size_t count = 0;
+        VKLInterval interval;
+        while (count < maxIntervals &&
+               vklIterateInterval(&iterator, &interval)) {
+          const VKLInterval &streamed = intervals[i * maxIntervals + count];
+          REQUIRE(streamed.tRange.lower == Approx(interval.tRange.lower));
+          REQUIRE(streamed.tRange.upper == Approx(interval.tRange.upper));
+          REQUIRE(streamed.valueRange.lower == interval.valueRange.lower);
+          REQUIRE(streamed.valueRange.upper == interval.valueRange.upper);
+          count++;
+        }
+
+        REQUIRE(numIntervals[i] == count);
+        numHits += (count > 0);
+      }
+
+      REQUIRE(numHits > 0);
+      REQUIRE(numHits < numRays);
+    }
+  }
+
+  vklRelease(rangeSelector);
+}
+
 void scalar_interval_nominalDeltaT(VKLVolume volume,
                                    const vec3f &direction,
                                    const float expectedNominalDeltaT)
@@ -238,6 +629,46 @@ TEST_CASE("Interval iterator", "[interval_iterators]")
     {
       scalar_interval_value_ranges_with_value_selector(vklVolume);
     }
+
+    SECTION("scalar interval majorants")
+    {
+      scalar_interval_majorants(vklVolume);
+    }
+
+    SECTION("scalar interval iterator size")
+    {
+      scalar_interval_iterator_size(vklVolume);
+    }
+
+    SECTION("scalar interval checkpoints")
+    {
+      scalar_interval_checkpoints(vklVolume);
+    }
+
+    SECTION("scalar interval checkpoints with clipping")
+    {
+      // clips a slab out of the first macrocell, which then gives two
+      // intervals; resuming between them continues in the same cell
+      const vkl_box3f clipBox{{-1.f, -1.f, 0.02f}, {2.f, 2.f, 0.05f}};
+
+      VKLValueSelector valueSelector = vklNewValueSelector(vklVolume);
+      vklValueSelectorSetClipBoxes(valueSelector, 1, &clipBox);
+      vklCommit(valueSelector);
+
+      scalar_interval_checkpoints(vklVolume, valueSelector);
+
+      vklRelease(valueSelector);
+    }
+
+    SECTION("scalar interval clipping")
+    {
+      scalar_interval_clipping(vklVolume, true);
+    }
+
+    SECTION("interval stream")
+    {
+      interval_stream(vklVolume);
+    }
   }
 
   SECTION("structured volumes: interval nominalDeltaT")
@@ -314,6 +745,45 @@ TEST_CASE("Interval iterator", "[interval_iterators]")
     }
   }
 
+  SECTION("vdb volumes")
+  {
+    // values change across every leaf boundary along the ray, and trilinear
+    // samples in the last voxel of a leaf read the next leaf
+    auto v = ospcommon::make_unique<ZVdbVolume>(
+        vec3i(128), vec3f(0.f), vec3f(1.f));
+
+    VKLVolume vklVolume = v->getVKLVolume();
+
+    SECTION("scalar interval value ranges with no value selector")
+    {
+      scalar_interval_value_ranges_with_no_value_selector(vklVolume);
+    }
+
+    SECTION("scalar interval majorants")
+    {
+      scalar_interval_majorants(vklVolume);
+    }
+  }
+
+  SECTION("vdb volumes: tricubic filter")
+  {
+    // the B-spline stencil reaches into the previous and the next leaf
+    auto v = ospcommon::make_unique<ZVdbVolume>(
+        vec3i(128), vec3f(0.f), vec3f(1.f), VKL_FILTER_TRICUBIC);
+
+    VKLVolume vklVolume = v->getVKLVolume();
+
+    SECTION("scalar interval value ranges with no value selector")
+    {
+      scalar_interval_value_ranges_with_no_value_selector(vklVolume);
+    }
+
+    SECTION("scalar interval majorants")
+    {
+      scalar_interval_majorants(vklVolume);
+    }
+  }
+
   SECTION("unstructured volumes")
   {
     // for a unit cube physical grid [(0,0,0), (1,1,1)]
@@ -340,5 +810,30 @@ TEST_CASE("Interval iterator", "[interval_iterators]")
     {
       scalar_interval_value_ranges_with_value_selector(vklVolume);
     }
+
+    SECTION("scalar interval majorants")
+    {
+      scalar_interval_majorants(vklVolume);
+    }
+
+    SECTION("scalar interval iterator size")
+    {
+      scalar_interval_iterator_size(vklVolume);
+    }
+
+    SECTION("scalar interval checkpoints")
+    {
+      scalar_interval_checkpoints(vklVolume);
+    }
+
+    SECTION("scalar interval clipping")
+    {
+      scalar_interval_clipping(vklVolume, false);
+    }
+
+    SECTION("interval stream")
+    {
+      interval_stream(vklVolume);
+    }
   }
 }
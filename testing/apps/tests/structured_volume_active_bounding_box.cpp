@@ -0,0 +1,280 @@
+// Copyright 2019-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+#include "ospcommon/utility/multidim_index_sequence.h"
+
+using namespace ospcommon;
+using namespace openvkl::testing;
+
+// A structured regular volume which is zero except for a cube of ones.
+VKLVolume make_box_volume(const vec3i &dimensions,
+                          const vec3i &boxLower,
+                          const vec3i &boxUpper)
+{
+  std::vector<float> voxels(dimensions.long_product(), 0.f);
+  multidim_index_sequence<3> mis(dimensions);
+  for (const auto &offset : mis) {
+    if (offset.x >= boxLower.x && offset.x <= boxUpper.x &&
+        offset.y >= boxLower.y && offset.y <= boxUpper.y &&
+        offset.z >= boxLower.z && offset.z <= boxUpper.z) {
+      voxels[mis.flatten(offset)] = 1.f;
+    }
+  }
+
+  VKLVolume volume = vklNewVolume("structuredRegular");
+  vklSetVec3i(volume, "dimensions", dimensions.x, dimensions.y, dimensions.z);
+
+  VKLData data = vklNewData(voxels.size(), VKL_FLOAT, voxels.data());
+  vklSetData(volume, "data", data);
+  vklRelease(data);
+
+  vklCommit(volume);
+
+  return volume;
+}
+
+// An unstructured volume of unit hexahedra which is zero except for a cube of
+// ones.
+VKLVolume make_unstructured_box_volume(const vec3i &dimensions,
+                                       const vec3i &boxLower,
+                                       const vec3i &boxUpper)
+{
+  const vec3i vertexDimensions = dimensions + 1;
+
+  std::vector<vec3f> positions;
+  for (const auto &v : multidim_index_sequence<3>(vertexDimensions))
+    positions.push_back(vec3f(v));
+
+  const vec3i corners[8] = {vec3i(0, 0, 0),
+                            vec3i(1, 0, 0),
+                            vec3i(1, 1, 0),
+                            vec3i(0, 1, 0),
+                            vec3i(0, 0, 1),
+                            vec3i(1, 0, 1),
+                            vec3i(1, 1, 1),
+                            vec3i(0, 1, 1)};
+
+  multidim_index_sequence<3> vertexIndices(vertexDimensions);
+  std::vector<uint32_t> index;
+  std::vector<uint32_t> cellIndex;
+  std::vector<uint8_t> cellType;
+  std::vector<float> cellValues;
+  for (const auto &c : multidim_index_sequence<3>(dimensions)) {
+    cellIndex.push_back(index.size());
+    cellType.push_back(VKL_HEXAHEDRON);
+    for (const vec3i &corner : corners)
+      index.push_back(vertexIndices.flatten(c + corner));
+
+    const bool inBox = c.x >= boxLower.x && c.x <= boxUpper.x &&
+                       c.y >= boxLower.y && c.y <= boxUpper.y &&
+                       c.z >= boxLower.z && c.z <= boxUpper.z;
+    cellValues.push_back(inBox ? 1.f : 0.f);
+  }
+
+  VKLVolume volume = vklNewVolume("unstructured");
+
+  VKLData data = vklNewData(positions.size(), VKL_VEC3F, positions.data());
+  vklSetData(volume, "vertex.position", data);
+  vklRelease(data);
+
+  data = vklNewData(index.size(), VKL_UINT, index.data());
+  vklSetData(volume, "index", data);
+  vklRelease(data);
+
+  data = vklNewData(cellIndex.size(), VKL_UINT, cellIndex.data());
+  vklSetData(volume, "cell.index", data);
+  vklRelease(data);
+
+  data = vklNewData(cellType.size(), VKL_UCHAR, cellType.data());
+  vklSetData(volume, "cell.type", data);
+  vklRelease(data);
+
+  data = vklNewData(cellValues.size(), VKL_FLOAT, cellValues.data());
+  vklSetData(volume, "cell.data", data);
+  vklRelease(data);
+
+  vklCommit(volume);
+
+  return volume;
+}
+
+// Returns the start of the first interval along a ray in z, or inf if there
+// is none.
+float first_interval_start(VKLVolume volume,
+                           const vkl_vec3f &origin,
+                           const vkl_range1f &valueRange)
+{
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, inf};
+
+  VKLValueSelector valueSelector = vklNewValueSelector(volume);
+  vklValueSelectorSetRanges(valueSelector, 1, &valueRange);
+  vklCommit(valueSelector);
+
+  VKLIntervalIterator iterator;
+  vklInitIntervalIterator(
+      &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+  VKLInterval interval;
+  const bool hasInterval = vklIterateInterval(&iterator, &interval);
+
+  vklRelease(valueSelector);
+
+  return hasInterval ? interval.tRange.lower : inf;
+}
+
+// Returns the t of the first hit along a ray in z, or inf if there is none.
+float first_hit(VKLVolume volume, const vkl_vec3f &origin, float isoValue)
+{
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, inf};
+
+  VKLValueSelector valueSelector = vklNewValueSelector(volume);
+  vklValueSelectorSetValues(valueSelector, 1, &isoValue);
+  vklCommit(valueSelector);
+
+  VKLHitIterator iterator;
+  vklInitHitIterator(
+      &iterator, volume, &origin, &direction, &tRange, valueSelector);
+
+  VKLHit hit;
+  const bool hasHit = vklIterateHit(&iterator, &hit);
+
+  vklRelease(valueSelector);
+
+  return hasHit ? hit.t : inf;
+}
+
+TEST_CASE("Structured volume active bounding box", "[volume_bounding_box]")
+{
+  vklLoadModule("ispc_driver");
+
+  VKLDriver driver = vklNewDriver("ispc");
+  vklCommitDriver(driver);
+  vklSetCurrentDriver(driver);
+
+  const vec3i dimensions(64);
+
+  SECTION("active bounding box contains the non-zero voxels")
+  {
+    VKLVolume volume = make_box_volume(dimensions, vec3i(20), vec3i(24));
+
+    const vkl_box3f boundingBox       = vklGetBoundingBox(volume);
+    const vkl_box3f activeBoundingBox = vklGetActiveBoundingBox(volume);
+
+    INFO("active bounding box = ("
+         << activeBoundingBox.lower.x << ", " << activeBoundingBox.lower.y
+         << ", " << activeBoundingBox.lower.z << ") -> ("
+         << activeBoundingBox.upper.x << ", " << activeBoundingBox.upper.y
+         << ", " << activeBoundingBox.upper.z << ")");
+
+    REQUIRE(activeBoundingBox.lower.x <= 20.f);
+    REQUIRE(activeBoundingBox.lower.y <= 20.f);
+    REQUIRE(activeBoundingBox.lower.z <= 20.f);
+    REQUIRE(activeBoundingBox.upper.x >= 24.f);
+    REQUIRE(activeBoundingBox.upper.y >= 24.f);
+    REQUIRE(activeBoundingBox.upper.z >= 24.f);
+
+    // the active bounding box is tighter than the bounding box
+    REQUIRE(activeBoundingBox.lower.z > boundingBox.lower.z);
+    REQUIRE(activeBoundingBox.upper.z < boundingBox.upper.z);
+
+    // the box lies in the second macrocell along each axis (16 voxels per
+    // macrocell), and the active bounding box is padded by one voxel
+    CHECK(activeBoundingBox.lower.z == 15.f);
+    CHECK(activeBoundingBox.upper.z == 33.f);
+
+    // rays are clipped to the active bounding box unless zero is selected.
+    // clipping must not cut into the first macrocell with non-zero values, so
+    // the first interval starts exactly where the ray enters it.
+    const vkl_vec3f inside{22.f, 22.f, -1.f};
+    CHECK(first_interval_start(volume, inside, {0.5f, 2.f}) ==
+          Approx(1.f + 16.f));
+    CHECK(first_interval_start(volume, inside, {-1.f, 2.f}) ==
+          Approx(1.f + boundingBox.lower.z));
+
+    // rays that miss the active bounding box only find zero values
+    const vkl_vec3f outside{5.f, 5.f, -1.f};
+    CHECK(first_interval_start(volume, outside, {0.5f, 2.f}) == inf);
+    CHECK(first_interval_start(volume, outside, {-1.f, 2.f}) ==
+          Approx(1.f + boundingBox.lower.z));
+
+    // hits are found at their exact position behind the clipped ray start,
+    // so that they do not depend on where stepping starts
+    vklSetBool(volume, "exactHits", true);
+    vklCommit(volume);
+
+    CHECK(first_hit(volume, inside, 0.5f) == Approx(1.f + 19.5f));
+    CHECK(first_hit(volume, outside, 0.5f) == inf);
+
+    vklRelease(volume);
+  }
+
+  SECTION("active bounding box of an all-zero volume is empty")
+  {
+    VKLVolume volume = make_box_volume(dimensions, vec3i(1), vec3i(0));
+
+    const vkl_box3f activeBoundingBox = vklGetActiveBoundingBox(volume);
+
+    REQUIRE(activeBoundingBox.upper.x < activeBoundingBox.lower.x);
+
+    vklRelease(volume);
+  }
+}
+
+TEST_CASE("Unstructured volume active bounding box", "[volume_bounding_box]")
+{
+  vklLoadModule("ispc_driver");
+
+  VKLDriver driver = vklNewDriver("ispc");
+  vklCommitDriver(driver);
+  vklSetCurrentDriver(driver);
+
+  const vec3i dimensions(32);
+
+  SECTION("active bounding box contains the non-zero cells")
+  {
+    VKLVolume volume =
+        make_unstructured_box_volume(dimensions, vec3i(12), vec3i(15));
+
+    const vkl_box3f boundingBox       = vklGetBoundingBox(volume);
+    const vkl_box3f activeBoundingBox = vklGetActiveBoundingBox(volume);
+
+    INFO("active bounding box = ("
+         << activeBoundingBox.lower.x << ", " << activeBoundingBox.lower.y
+         << ", " << activeBoundingBox.lower.z << ") -> ("
+         << activeBoundingBox.upper.x << ", " << activeBoundingBox.upper.y
+         << ", " << activeBoundingBox.upper.z << ")");
+
+    // the non-zero cells cover [12, 16] on each axis
+    REQUIRE(activeBoundingBox.lower.x <= 12.f);
+    REQUIRE(activeBoundingBox.lower.y <= 12.f);
+    REQUIRE(activeBoundingBox.lower.z <= 12.f);
+    REQUIRE(activeBoundingBox.upper.x >= 16.f);
+    REQUIRE(activeBoundingBox.upper.y >= 16.f);
+    REQUIRE(activeBoundingBox.upper.z >= 16.f);
+
+    // the active bounding box lies within the bounding box, and BVH leaves
+    // are small enough for it to be tighter
+    REQUIRE(activeBoundingBox.lower.x >= boundingBox.lower.x);
+    REQUIRE(activeBoundingBox.upper.x <= boundingBox.upper.x);
+    REQUIRE(activeBoundingBox.lower.z > boundingBox.lower.z);
+    REQUIRE(activeBoundingBox.upper.z < boundingBox.upper.z);
+
+    vklRelease(volume);
+  }
+
+  SECTION("active bounding box of an all-zero volume is empty")
+  {
+    VKLVolume volume =
+        make_unstructured_box_volume(dimensions, vec3i(1), vec3i(0));
+
+    const vkl_box3f activeBoundingBox = vklGetActiveBoundingBox(volume);
+
+    REQUIRE(activeBoundingBox.upper.x < activeBoundingBox.lower.x);
+
+    vklRelease(volume);
+  }
+}
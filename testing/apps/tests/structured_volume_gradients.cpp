@@ -82,3 +82,55 @@ TEST_CASE("Structured volume gradients", "[volume_gradients]")
     scalar_gradients<XYZStructuredSphericalVolume<float>>(0.1f, true);
   }
 }
+
+TEST_CASE("Structured volume tricubic filter", "[volume_gradients]")
+{
+  vklLoadModule("ispc_driver");
+
+  VKLDriver driver = vklNewDriver("ispc");
+  vklCommitDriver(driver);
+  vklSetCurrentDriver(driver);
+
+  // The B-spline filter reproduces linear functions wherever its stencil
+  // does not reach beyond the boundary.
+  const vec3i dimensions(16);
+  const vec3f gridSpacing(0.5f, 1.f, 2.f);
+
+  std::vector<float> voxels(dimensions.long_product());
+  multidim_index_sequence<3> mis(dimensions);
+  for (const auto &offset : mis) {
+    voxels[mis.flatten(offset)] = 2.f * offset.x + 3.f * offset.y - offset.z;
+  }
+
+  VKLVolume volume = vklNewVolume("structuredRegular");
+  vklSetVec3i(volume, "dimensions", dimensions.x, dimensions.y, dimensions.z);
+  vklSetVec3f(volume, "gridSpacing", gridSpacing.x, gridSpacing.y, gridSpacing.z);
+  vklSetInt(volume, "filter", VKL_FILTER_TRICUBIC);
+
+  VKLData data = vklNewData(voxels.size(), VKL_FLOAT, voxels.data());
+  vklSetData(volume, "data", data);
+  vklRelease(data);
+
+  vklCommit(volume);
+
+  const std::vector<vec3f> localCoordinates = {vec3f(1.5f, 2.25f, 3.75f),
+                                               vec3f(7.f, 8.f, 9.f),
+                                               vec3f(13.9f, 1.1f, 6.5f)};
+
+  for (const vec3f &lc : localCoordinates) {
+    const vec3f objectCoordinates = lc * gridSpacing;
+    INFO("localCoordinates = " << lc.x << " " << lc.y << " " << lc.z);
+
+    const float sample =
+        vklComputeSample(volume, (const vkl_vec3f *)&objectCoordinates);
+    CHECK(sample == Approx(2.f * lc.x + 3.f * lc.y - lc.z));
+
+    const vkl_vec3f gradient =
+        vklComputeGradient(volume, (const vkl_vec3f *)&objectCoordinates);
+    CHECK(gradient.x == Approx(2.f / gridSpacing.x));
+    CHECK(gradient.y == Approx(3.f / gridSpacing.y));
+    CHECK(gradient.z == Approx(-1.f / gridSpacing.z));
+  }
+
+  vklRelease(volume);
+}
@@ -125,6 +125,138 @@ void scalar_sampling_on_vertices_vs_procedural_values(
   }
 }
 
+void scalar_sampling_bvh_build_parameters(const std::string &bvhBuildQuality,
+                                          int maxLeafSize)
+{
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v(
+      new WaveletUnstructuredProceduralVolume(
+          vec3i(32), vec3f(0.f), vec3f(1.f), VKL_HEXAHEDRON, true));
+
+  VKLVolume vklVolume = v->getVKLVolume();
+
+  vklSetString(vklVolume, "bvhBuildQuality", bvhBuildQuality.c_str());
+  vklSetInt(vklVolume, "maxLeafSize", maxLeafSize);
+  vklCommit(vklVolume);
+
+  multidim_index_sequence<3> mis(v->getDimensions());
+
+  for (const auto &offset : mis) {
+    vec3f objectCoordinates = v->getGridOrigin() + offset * v->getGridSpacing();
+
+    INFO("bvhBuildQuality = " << bvhBuildQuality
+                              << " maxLeafSize = " << maxLeafSize);
+    INFO("offset = " << offset.x << " " << offset.y << " " << offset.z);
+
+    vec3f offsetCoordinates = objectCoordinates + vec3f(0.1f);
+    CHECK(
+        vklComputeSample(vklVolume, (const vkl_vec3f *)&(offsetCoordinates)) ==
+        Approx(v->computeProceduralValue(objectCoordinates)).margin(1e-4f));
+  }
+}
+
+uint64_t memory_usage(VKLVolume vklVolume)
+{
+  VKLObserver observer = vklNewObserver(vklVolume, "MemoryUsage");
+  REQUIRE(observer);
+  REQUIRE(vklGetObserverElementType(observer) == VKL_ULONG);
+  REQUIRE(vklGetObserverNumElements(observer) == 1);
+
+  const uint64_t *bytesUsed =
+      static_cast<const uint64_t *>(vklMapObserver(observer));
+  REQUIRE(bytesUsed);
+  const uint64_t result = *bytesUsed;
+
+  vklUnmapObserver(observer);
+  vklRelease(observer);
+
+  return result;
+}
+
+void scalar_sampling_quantized_vertices(bool precomputedNormals)
+{
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v(
+      new WaveletUnstructuredProceduralVolume(
+          vec3i(32), vec3f(0.f), vec3f(1.f), VKL_HEXAHEDRON, true));
+
+  VKLVolume vklVolume = v->getVKLVolume();
+
+  vklSetBool(vklVolume, "quantizeVertices", true);
+  vklSetBool(vklVolume, "precomputedNormals", precomputedNormals);
+  vklCommit(vklVolume);
+
+  multidim_index_sequence<3> mis(v->getDimensions());
+
+  for (const auto &offset : mis) {
+    vec3f objectCoordinates = v->getGridOrigin() + offset * v->getGridSpacing();
+
+    INFO("precomputedNormals = " << precomputedNormals);
+    INFO("offset = " << offset.x << " " << offset.y << " " << offset.z);
+
+    vec3f offsetCoordinates = objectCoordinates + vec3f(0.1f);
+    CHECK(
+        vklComputeSample(vklVolume, (const vkl_vec3f *)&(offsetCoordinates)) ==
+        Approx(v->computeProceduralValue(objectCoordinates)).margin(1e-4f));
+  }
+}
+
+void quantized_vertices_memory_usage()
+{
+  // Vertices lie on integer multiples of the quantization step (the vertex
+  // bounding box is [0, 65535]), so all three representations describe the
+  // same geometry and build the same BVH.
+  const vec3i dimensions(15);
+  const float spacing = 65535.f / dimensions.x;
+
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v(
+      new WaveletUnstructuredProceduralVolume(
+          dimensions, vec3f(0.f), vec3f(spacing), VKL_HEXAHEDRON, true));
+
+  VKLVolume vklVolume = v->getVKLVolume();
+
+  std::vector<vec3f> samplePositions;
+  multidim_index_sequence<3> mis(dimensions);
+  for (const auto &offset : mis)
+    samplePositions.push_back((vec3f(offset) + vec3f(0.3f)) * spacing);
+
+  auto computeSamples = [&]() {
+    std::vector<float> samples;
+    for (const vec3f &p : samplePositions)
+      samples.push_back(vklComputeSample(vklVolume, (const vkl_vec3f *)&p));
+    return samples;
+  };
+
+  const uint64_t floatBytes         = memory_usage(vklVolume);
+  const std::vector<float> expected = computeSamples();
+
+  vklSetBool(vklVolume, "quantizeVertices", true);
+  vklCommit(vklVolume);
+
+  // quantizeVertices keeps an internal copy of 6 bytes per vertex
+  const uint64_t numVertices = (dimensions + vec3i(1)).long_product();
+  CHECK(memory_usage(vklVolume) ==
+        floatBytes + numVertices * 3 * sizeof(uint16_t));
+  CHECK(computeSamples() == expected);
+
+  // pre-quantized positions are used without a copy
+  std::vector<uint16_t> quantized;
+  multidim_index_sequence<3> vertices(dimensions + vec3i(1));
+  for (const auto &offset : vertices) {
+    for (int axis = 0; axis < 3; axis++)
+      quantized.push_back(uint16_t(offset[axis] * spacing));
+  }
+
+  VKLData positions =
+      vklNewData(quantized.size(), VKL_USHORT, quantized.data());
+  vklSetData(vklVolume, "vertex.position", positions);
+  vklRelease(positions);
+  vklSetVec3f(vklVolume, "quantizationOrigin", 0.f, 0.f, 0.f);
+  vklSetVec3f(vklVolume, "quantizationScale", 1.f, 1.f, 1.f);
+  vklCommit(vklVolume);
+
+  CHECK(memory_usage(vklVolume) == floatBytes);
+  CHECK(computeSamples() == expected);
+}
+
 TEST_CASE("Unstructured volume sampling", "[volume_sampling]")
 {
   vklLoadModule("ispc_driver");
@@ -220,4 +352,20 @@ TEST_CASE("Unstructured volume sampling", "[volume_sampling]")
           VKL_PYRAMID, cellValued, indexPrefix, precomputedNormals, false);
     }
   }
+
+  SECTION("BVH build parameters")
+  {
+    for (const auto &quality : {"low", "medium", "high"}) {
+      for (int maxLeafSize : {1, 4, 16}) {
+        scalar_sampling_bvh_build_parameters(quality, maxLeafSize);
+      }
+    }
+  }
+
+  SECTION("quantized vertices")
+  {
+    scalar_sampling_quantized_vertices(false);
+    scalar_sampling_quantized_vertices(true);
+    quantized_vertices_memory_usage();
+  }
 }
@@ -1,6 +1,9 @@
 // Copyright 2020 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include "../../external/catch.hpp"
 #include "openvkl_testing.h"
 #include "ospcommon/utility/multidim_index_sequence.h"
@@ -137,3 +140,653 @@ TEST_CASE("VDB volume interval iterator", "[volume_sampling]")
       &iterator, vklVolume, &origin, &direction, &tRange, nullptr));
   REQUIRE_NOTHROW(vklIterateInterval(&iterator, &interval));
 }
+
+TEST_CASE("VDB volume interval iterator traversal", "[volume_sampling]")
+{
+  init_driver();
+
+  // The first two leaves share their parent node. The others are in
+  // different nodes one and two levels further up, so that the iterator must
+  // ascend by one and by two levels to reach them.
+  const uint32_t leafLevel = vklVdbNumLevels() - 1;
+  const uint32_t numVoxels = vklVdbLevelNumVoxels(leafLevel);
+  const int leafRes        = vklVdbLevelRes(leafLevel);
+  const std::vector<int> leafX = {0,
+                                  2 * leafRes,
+                                  (int)vklVdbLevelRes(leafLevel - 1),
+                                  (int)vklVdbLevelRes(leafLevel - 2)};
+
+  std::vector<std::vector<float>> values(leafX.size());
+  vdb_util::VdbVolumeBuffers<VKL_FLOAT> buffers;
+  for (size_t i = 0; i < leafX.size(); ++i) {
+    values[i].resize(numVoxels, static_cast<float>(i + 1));
+    buffers.addConstant(leafLevel,
+                        vec3i(leafX[i], 0, 0),
+                        values[i].data(),
+                        VKL_DATA_DEFAULT);
+  }
+  VKLVolume volume = buffers.createVolume(VKL_FILTER_NEAREST);
+
+  // A ray along x that starts one voxel in front of the first leaf.
+  VKLIntervalIterator iterator;
+  VKLInterval interval;
+  vkl_vec3f origin{-1.f, 0.5f * leafRes, 0.5f * leafRes};
+  vkl_vec3f direction{1.f, 0.f, 0.f};
+  vkl_range1f tRange{0.f, 1e7f};
+  vklInitIntervalIterator(
+      &iterator, volume, &origin, &direction, &tRange, nullptr);
+
+  for (size_t i = 0; i < leafX.size(); ++i) {
+    INFO("leaf " << i);
+    REQUIRE(vklIterateInterval(&iterator, &interval));
+    CHECK(interval.tRange.lower == Approx(leafX[i] + 1.f));
+    CHECK(interval.tRange.upper == Approx(leafX[i] + leafRes + 1.f));
+    CHECK(interval.valueRange.lower == static_cast<float>(i + 1));
+    CHECK(interval.valueRange.upper == static_cast<float>(i + 1));
+  }
+  CHECK(!vklIterateInterval(&iterator, &interval));
+
+  // Suspend after each leaf, and resume on a different iterator. Resuming
+  // must restore the node path, including across the level changes.
+  for (size_t i = 0; i <= leafX.size(); ++i) {
+    INFO("suspended after leaf " << i);
+    vklInitIntervalIterator(
+        &iterator, volume, &origin, &direction, &tRange, nullptr);
+    for (size_t j = 0; j < i; ++j)
+      REQUIRE(vklIterateInterval(&iterator, &interval));
+
+    VKLIntervalIteratorCheckpoint checkpoint;
+    vklGetIntervalIteratorCheckpoint(&iterator, &checkpoint);
+
+    VKLIntervalIterator resumed;
+    vklResumeIntervalIterator(&resumed,
+                              volume,
+                              &origin,
+                              &direction,
+                              &tRange,
+                              &checkpoint,
+                              nullptr);
+
+    for (size_t j = i; j < leafX.size(); ++j) {
+      REQUIRE(vklIterateInterval(&resumed, &interval));
+      CHECK(interval.tRange.lower == Approx(leafX[j] + 1.f));
+      CHECK(interval.valueRange.lower == static_cast<float>(j + 1));
+    }
+    CHECK(!vklIterateInterval(&resumed, &interval));
+  }
+
+  vklRelease(volume);
+}
+
+TEST_CASE("VDB volume observers", "[volume_observers]")
+{
+  init_driver();
+
+  WaveletVdbVolume *volume = nullptr;
+  REQUIRE_NOTHROW(volume = new WaveletVdbVolume(
+                      128, vec3f(0.f), vec3f(1.f), VKL_FILTER_TRILINEAR));
+  VKLVolume vklVolume = volume->getVKLVolume();
+
+  SECTION("MemoryUsage")
+  {
+    VKLObserver observer = vklNewObserver(vklVolume, "MemoryUsage");
+    REQUIRE(observer);
+    REQUIRE(vklGetObserverElementType(observer) == VKL_ULONG);
+    REQUIRE(vklGetObserverNumElements(observer) == 1);
+
+    const uint64_t *bytesUsed =
+        static_cast<const uint64_t *>(vklMapObserver(observer));
+    REQUIRE(bytesUsed);
+    CHECK(*bytesUsed > 0);
+
+    vklUnmapObserver(observer);
+    vklRelease(observer);
+  }
+
+  SECTION("LeafNodeAccess")
+  {
+    VKLObserver observer = vklNewObserver(vklVolume, "LeafNodeAccess");
+    REQUIRE(observer);
+    REQUIRE(vklGetObserverElementType(observer) == VKL_UINT);
+    const size_t numLeaves = vklGetObserverNumElements(observer);
+    REQUIRE(numLeaves > 0);
+
+    const vkl_vec3f objectCoordinates{64.5f, 64.5f, 64.5f};
+    vklComputeSample(vklVolume, &objectCoordinates);
+
+    const uint32_t *accessed =
+        static_cast<const uint32_t *>(vklMapObserver(observer));
+    REQUIRE(accessed);
+    CHECK(std::count_if(accessed, accessed + numLeaves, [](uint32_t a) {
+            return a != 0;
+          }) > 0);
+
+    vklUnmapObserver(observer);
+    vklRelease(observer);
+  }
+
+  SECTION("LeafNodeAccess after uncommitted parameter changes")
+  {
+    // The observer uses the leaves of the last commit.
+    const uint32_t level = vklVdbNumLevels() - 1;
+    const vkl_vec3i origin{0, 0, 0};
+    VKLData dataLevel  = vklNewData(1, VKL_UINT, &level);
+    VKLData dataOrigin = vklNewData(1, VKL_VEC3I, &origin);
+    vklSetData(vklVolume, "level", dataLevel);
+    vklSetData(vklVolume, "origin", dataOrigin);
+    vklRelease(dataLevel);
+    vklRelease(dataOrigin);
+
+    VKLObserver observer = vklNewObserver(vklVolume, "LeafNodeAccess");
+    REQUIRE(observer);
+    REQUIRE(vklGetObserverNumElements(observer) > 1);
+    vklRelease(observer);
+  }
+
+  REQUIRE_NOTHROW(delete volume);
+}
+
+TEST_CASE("VDB volume temporal formats", "[volume_sampling]")
+{
+  init_driver();
+
+  const uint32_t leafLevel = vklVdbNumLevels() - 1;
+  const uint32_t numVoxels = vklVdbLevelNumVoxels(leafLevel);
+  const vkl_vec3f objectCoordinates{1.5f, 1.5f, 1.5f};
+
+  SECTION("temporally structured")
+  {
+    const uint32_t numTimesteps = 3;
+    std::vector<float> values(numVoxels * numTimesteps);
+    for (uint32_t v = 0; v < numVoxels; ++v)
+      for (uint32_t t = 0; t < numTimesteps; ++t)
+        values[v * numTimesteps + t] = static_cast<float>(t);
+
+    vdb_util::VdbVolumeBuffers<VKL_FLOAT> buffers;
+    buffers.addTemporallyStructured(leafLevel,
+                                    vec3i(0),
+                                    numTimesteps,
+                                    values.data(),
+                                    VKL_DATA_DEFAULT);
+    VKLVolume volume = buffers.createVolume(VKL_FILTER_NEAREST);
+
+    const vkl_range1f range = vklGetValueRange(volume);
+    CHECK(range.lower == 0.f);
+    CHECK(range.upper == 2.f);
+
+    CHECK(vklComputeSample(volume, &objectCoordinates) == 0.f);
+    CHECK(vklComputeSampleTime(volume, &objectCoordinates, 0.25f) ==
+          Approx(0.5f));
+    CHECK(vklComputeSampleTime(volume, &objectCoordinates, 0.75f) ==
+          Approx(1.5f));
+    CHECK(vklComputeSampleTime(volume, &objectCoordinates, 1.f) == 2.f);
+
+    vklRelease(volume);
+  }
+
+  SECTION("temporally unstructured")
+  {
+    // Voxel 0 has a single time step, all others have two.
+    std::vector<uint32_t> indices(numVoxels + 1);
+    std::vector<float> times;
+    std::vector<float> values;
+    for (uint32_t v = 0; v < numVoxels; ++v) {
+      indices[v] = times.size();
+      if (v == 0) {
+        times.push_back(0.5f);
+        values.push_back(7.f);
+      } else {
+        times.insert(times.end(), {0.f, 1.f});
+        values.insert(values.end(), {0.f, 4.f});
+      }
+    }
+    indices[numVoxels] = times.size();
+
+    vdb_util::VdbVolumeBuffers<VKL_FLOAT> buffers;
+    buffers.addTemporallyUnstructured(
+        leafLevel, vec3i(0), indices.data(), times.data(), values.data());
+    VKLVolume volume = buffers.createVolume(VKL_FILTER_NEAREST);
+
+    const vkl_range1f range = vklGetValueRange(volume);
+    CHECK(range.lower == 0.f);
+    CHECK(range.upper == 7.f);
+
+    CHECK(vklComputeSample(volume, &objectCoordinates) == 0.f);
+    CHECK(vklComputeSampleTime(volume, &objectCoordinates, 0.25f) ==
+          Approx(1.f));
+    CHECK(vklComputeSampleTime(volume, &objectCoordinates, 1.f) == 4.f);
+
+    const vkl_vec3f voxel0{0.5f, 0.5f, 0.5f};
+    CHECK(vklComputeSampleTime(volume, &voxel0, 0.f) == 7.f);
+    CHECK(vklComputeSampleTime(volume, &voxel0, 1.f) == 7.f);
+
+    vklRelease(volume);
+  }
+}
+
+static int fill_paged_leaf(void *userData,
+                           vkl_uint64 nodeIndex,
+                           vkl_uint32 level,
+                           float *buffer)
+{
+  const float value = *static_cast<const float *>(userData);
+  std::fill(buffer, buffer + vklVdbLevelNumVoxels(level), value);
+  return 1;
+}
+
+TEST_CASE("VDB volume paged leaves", "[volume_sampling]")
+{
+  init_driver();
+
+  const uint32_t level   = vklVdbNumLevels() - 1;
+  const vec3i origin     = vec3i(0);
+  const uint32_t format  = VKL_VDB_FORMAT_CONSTANT;
+  const VKLData data     = nullptr;
+  const range1f range    = range1f(0.f, 8.f);
+  const float pagedValue = 6.f;
+
+  VKLVolume volume = vklNewVolume("vdb");
+  vklSetInt(volume, "type", VKL_FLOAT);
+  vklSetInt(volume, "filter", VKL_FILTER_NEAREST);
+  vklSetData(volume, "level", vklNewData(1, VKL_UINT, &level));
+  vklSetData(volume, "origin", vklNewData(1, VKL_VEC3I, &origin));
+  vklSetData(volume, "format", vklNewData(1, VKL_UINT, &format));
+  vklSetData(volume, "data", vklNewData(1, VKL_DATA, &data));
+  vklSetData(volume, "pagedValueRange", vklNewData(1, VKL_BOX1F, &range));
+  vklSetVoidPtr(volume,
+                "leafLoader",
+                reinterpret_cast<void *>(&fill_paged_leaf));
+  vklSetVoidPtr(
+      volume, "leafLoaderUserData", const_cast<float *>(&pagedValue));
+  vklSetInt(volume, "maxResidentLeaves", 1);
+  vklSetBool(volume, "waitForLeafLoads", true);
+  vklCommit(volume);
+
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+  CHECK(valueRange.lower == range.lower);
+  CHECK(valueRange.upper == range.upper);
+
+  // Non-resident leaves return the midpoint of their value range. The
+  // request is loaded before vklComputeSample returns.
+  const vkl_vec3f objectCoordinates{1.5f, 1.5f, 1.5f};
+  CHECK(vklComputeSample(volume, &objectCoordinates) == 4.f);
+  CHECK(vklComputeSample(volume, &objectCoordinates) == pagedValue);
+
+  vklRelease(volume);
+}
+
+// Every third leaf fails to load; the others hold their index plus one.
+static bool paged_leaf_fails(vkl_uint64 nodeIndex)
+{
+  return nodeIndex % 3 == 2;
+}
+
+static int fill_indexed_paged_leaf(void *,
+                                   vkl_uint64 nodeIndex,
+                                   vkl_uint32 level,
+                                   float *buffer)
+{
+  if (paged_leaf_fails(nodeIndex))
+    return 0;
+  std::fill(buffer, buffer + vklVdbLevelNumVoxels(level), nodeIndex + 1.f);
+  return 1;
+}
+
+static uint64_t memory_usage(VKLVolume volume)
+{
+  VKLObserver observer = vklNewObserver(volume, "MemoryUsage");
+  const uint64_t bytesUsed =
+      *static_cast<const uint64_t *>(vklMapObserver(observer));
+  vklUnmapObserver(observer);
+  vklRelease(observer);
+  return bytesUsed;
+}
+
+TEST_CASE("VDB volume paged leaf eviction", "[volume_sampling]")
+{
+  init_driver();
+
+  // More paged leaves than may be resident, in a row along x.
+  const uint32_t level             = vklVdbNumLevels() - 1;
+  const uint32_t leafRes           = vklVdbLevelRes(level);
+  const uint32_t numLeaves         = 16;
+  const uint32_t maxResidentLeaves = 4;
+  const float fallback             = 50.f;
+
+  std::vector<vec3i> origins(numLeaves);
+  for (uint32_t i = 0; i < numLeaves; ++i)
+    origins[i] = vec3i(i * leafRes, 0, 0);
+  const std::vector<uint32_t> levels(numLeaves, level);
+  const std::vector<uint32_t> formats(numLeaves, VKL_VDB_FORMAT_CONSTANT);
+  const std::vector<VKLData> data(numLeaves, nullptr);
+  const std::vector<range1f> ranges(numLeaves, range1f(0.f, 2.f * fallback));
+
+  auto makeVolume = [&](bool waitForLeafLoads) {
+    VKLVolume volume = vklNewVolume("vdb");
+    vklSetInt(volume, "type", VKL_FLOAT);
+    vklSetInt(volume, "filter", VKL_FILTER_NEAREST);
+    vklSetData(volume, "level", vklNewData(numLeaves, VKL_UINT, levels.data()));
+    vklSetData(
+        volume, "origin", vklNewData(numLeaves, VKL_VEC3I, origins.data()));
+    vklSetData(
+        volume, "format", vklNewData(numLeaves, VKL_UINT, formats.data()));
+    vklSetData(volume, "data", vklNewData(numLeaves, VKL_DATA, data.data()));
+    vklSetData(volume,
+               "pagedValueRange",
+               vklNewData(numLeaves, VKL_BOX1F, ranges.data()));
+    vklSetVoidPtr(volume,
+                  "leafLoader",
+                  reinterpret_cast<void *>(&fill_indexed_paged_leaf));
+    vklSetInt(volume, "maxResidentLeaves", maxResidentLeaves);
+    vklSetBool(volume, "waitForLeafLoads", waitForLeafLoads);
+    vklCommit(volume);
+    return volume;
+  };
+
+  auto leafCenter = [&](uint32_t i) {
+    return vkl_vec3f{i * leafRes + 1.5f, 1.5f, 1.5f};
+  };
+
+  auto expectedValue = [&](uint32_t i) {
+    return paged_leaf_fails(i) ? fallback : i + 1.f;
+  };
+
+  // Loaded buffers are the only allocations made after commit.
+  const uint64_t maxCacheBytes =
+      maxResidentLeaves * vklVdbLevelNumVoxels(level) * sizeof(float);
+
+  SECTION("waiting for loads")
+  {
+    VKLVolume volume        = makeVolume(true);
+    const uint64_t baseline = memory_usage(volume);
+
+    // Every round cycles through all leaves, so leaves are evicted and their
+    // buffers reused. A sample that requests a leaf returns once it is
+    // loaded, so the next sample sees the leaf data.
+    for (int round = 0; round < 4; ++round) {
+      for (uint32_t i = 0; i < numLeaves; ++i) {
+        INFO("round " << round << ", leaf " << i);
+        const vkl_vec3f p   = leafCenter(i);
+        const float sample0 = vklComputeSample(volume, &p);
+        CHECK((sample0 == fallback || sample0 == expectedValue(i)));
+        CHECK(vklComputeSample(volume, &p) == expectedValue(i));
+      }
+
+      const uint64_t bytesUsed = memory_usage(volume);
+      CHECK(bytesUsed > baseline);
+      CHECK(bytesUsed <= baseline + maxCacheBytes);
+    }
+
+    vklRelease(volume);
+  }
+
+  SECTION("asynchronous loads")
+  {
+    VKLVolume volume        = makeVolume(false);
+    const uint64_t baseline = memory_usage(volume);
+
+    for (int round = 0; round < 64; ++round) {
+      for (uint32_t i = 0; i < numLeaves; ++i) {
+        INFO("round " << round << ", leaf " << i);
+        const vkl_vec3f p  = leafCenter(i);
+        const float sample = vklComputeSample(volume, &p);
+        CHECK((sample == fallback || sample == expectedValue(i)));
+      }
+      CHECK(memory_usage(volume) <= baseline + maxCacheBytes);
+    }
+
+    // Leaves are loaded in the background without another commit, and
+    // failed leaves keep returning the fallback.
+    for (uint32_t i = 0; i < numLeaves; ++i) {
+      INFO("leaf " << i);
+      const vkl_vec3f p = leafCenter(i);
+      float sample      = vklComputeSample(volume, &p);
+      for (int n = 0; n < 10000 && sample != expectedValue(i); ++n) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        sample = vklComputeSample(volume, &p);
+      }
+      CHECK(sample == expectedValue(i));
+      if (paged_leaf_fails(i))
+        CHECK(vklComputeSample(volume, &p) == fallback);
+    }
+
+    CHECK(memory_usage(volume) <= baseline + maxCacheBytes);
+
+    vklRelease(volume);
+  }
+}
+
+TEST_CASE("VDB volume topologies", "[volume_sampling]")
+{
+  init_driver();
+
+  // A three level topology, which is compiled in by default (see
+  // VKL_VDB_EXTRA_LOG_RESOLUTIONS). Leaves have 8^3 voxels.
+  const std::vector<uint32_t> logResolution = {5, 4, 3};
+  const uint32_t level     = 2;
+  const uint32_t leafRes   = 8;
+  const uint32_t numVoxels = leafRes * leafRes * leafRes;
+
+  // Leaf values are their linear voxel index (z-major), plus an offset per
+  // leaf.
+  const std::vector<vec3i> origins = {vec3i(0), vec3i(8, 0, 0)};
+  std::vector<std::vector<float>> values(origins.size());
+  std::vector<VKLData> leafData(origins.size());
+  for (size_t i = 0; i < origins.size(); ++i) {
+    values[i].resize(numVoxels);
+    for (uint32_t v = 0; v < numVoxels; ++v)
+      values[i][v] = 1000.f * i + v;
+    leafData[i] = vklNewData(
+        numVoxels, VKL_FLOAT, values[i].data(), VKL_DATA_SHARED_BUFFER);
+  }
+
+  const std::vector<uint32_t> levels(origins.size(), level);
+  const std::vector<uint32_t> formats(origins.size(),
+                                      VKL_VDB_FORMAT_CONSTANT);
+
+  VKLVolume volume = vklNewVolume("vdb");
+  vklSetInt(volume, "type", VKL_FLOAT);
+  vklSetInt(volume, "filter", VKL_FILTER_NEAREST);
+  vklSetData(volume,
+             "logResolution",
+             vklNewData(logResolution.size(), VKL_UINT, logResolution.data()));
+  vklSetData(
+      volume, "level", vklNewData(levels.size(), VKL_UINT, levels.data()));
+  vklSetData(
+      volume, "origin", vklNewData(origins.size(), VKL_VEC3I, origins.data()));
+  vklSetData(
+      volume, "format", vklNewData(formats.size(), VKL_UINT, formats.data()));
+  vklSetData(
+      volume, "data", vklNewData(leafData.size(), VKL_DATA, leafData.data()));
+  vklCommit(volume);
+
+  const vkl_box3f bbox = vklGetBoundingBox(volume);
+  CHECK(bbox.upper.x == 16.f);
+  CHECK(bbox.upper.y == 8.f);
+  CHECK(bbox.upper.z == 8.f);
+
+  for (size_t i = 0; i < origins.size(); ++i) {
+    for (uint32_t x = 0; x < leafRes; x += 3) {
+      for (uint32_t y = 0; y < leafRes; y += 3) {
+        for (uint32_t z = 0; z < leafRes; z += 3) {
+          const vec3f objectCoordinates =
+              vec3f(origins[i] + vec3i(x, y, z)) + vec3f(0.5f);
+          const uint32_t v = (x * leafRes + y) * leafRes + z;
+          test_scalar_and_vector_sampling(
+              volume, objectCoordinates, values[i][v], 0.f);
+        }
+      }
+    }
+  }
+
+  vklRelease(volume);
+}
+
+TEST_CASE("VDB volume level of detail", "[volume_sampling]")
+{
+  init_driver();
+
+  const uint32_t leafLevel = vklVdbNumLevels() - 1;
+  const uint32_t numVoxels = vklVdbLevelNumVoxels(leafLevel);
+
+  std::vector<float> values(numVoxels);
+  double sum = 0.0;
+  for (uint32_t v = 0; v < numVoxels; ++v) {
+    values[v] = static_cast<float>(v);
+    sum += values[v];
+  }
+  const float leafMean = static_cast<float>(sum / numVoxels);
+
+  vdb_util::VdbVolumeBuffers<VKL_FLOAT> buffers;
+  buffers.addConstant(leafLevel, vec3i(0), values.data(), VKL_DATA_DEFAULT);
+  VKLVolume volume = buffers.createVolume(VKL_FILTER_NEAREST);
+
+  // The leaf is stored in a voxel on the level above, whose voxels have the
+  // size of a leaf node. On the level above that, the leaf is averaged with
+  // empty voxels.
+  const float leafNodeLod  = vklVdbLevelTotalLogRes(leafLevel);
+  const float parentLod    = vklVdbLevelTotalLogRes(leafLevel - 1);
+  const float parentMean   = leafMean / vklVdbLevelNumVoxels(leafLevel - 1);
+  const vkl_vec3f position = {1.5f, 2.5f, 3.5f};
+  const float leafValue    = vklComputeSample(volume, &position);
+
+  SECTION("scalar")
+  {
+    CHECK(vklComputeSampleLod(volume, &position, 0.f) == leafValue);
+    CHECK(vklComputeSampleLod(volume, &position, leafNodeLod - 0.5f) ==
+          leafValue);
+    CHECK(vklComputeSampleLod(volume, &position, leafNodeLod) ==
+          Approx(leafMean));
+    CHECK(vklComputeSampleLod(volume, &position, parentLod) ==
+          Approx(parentMean));
+  }
+
+  SECTION("vector")
+  {
+    const int valid[4] = {1, 1, 1, 1};
+    vkl_vvec3f4 positions;
+    for (int i = 0; i < 4; ++i) {
+      positions.x[i] = position.x;
+      positions.y[i] = position.y;
+      positions.z[i] = position.z;
+    }
+    const float lods[4] = {0.f, leafNodeLod, parentLod, leafNodeLod};
+    float samples[4];
+    vklComputeSampleLod4(valid, volume, &positions, lods, samples);
+
+    CHECK(samples[0] == leafValue);
+    CHECK(samples[1] == Approx(leafMean));
+    CHECK(samples[2] == Approx(parentMean));
+    CHECK(samples[3] == Approx(leafMean));
+  }
+
+  vklRelease(volume);
+}
+
+TEST_CASE("VDB volume leaf compaction", "[volume_sampling]")
+{
+  init_driver();
+
+  const uint32_t leafLevel = vklVdbNumLevels() - 1;
+  const uint32_t numVoxels = vklVdbLevelNumVoxels(leafLevel);
+  const int leafRes        = vklVdbLevelRes(leafLevel);
+
+  // A uniform leaf, followed by two leaves with identical contents. The
+  // volume shares our buffers, so that we can tell which buffer is read.
+  std::vector<float> uniform(numVoxels, 3.f);
+  std::vector<float> ramp(numVoxels);
+  for (uint32_t v = 0; v < numVoxels; ++v)
+    ramp[v] = static_cast<float>(v);
+  std::vector<float> rampCopy = ramp;
+
+  vdb_util::VdbVolumeBuffers<VKL_FLOAT> buffers;
+  buffers.addConstant(
+      leafLevel, vec3i(0), uniform.data(), VKL_DATA_SHARED_BUFFER);
+  buffers.addConstant(
+      leafLevel, vec3i(leafRes, 0, 0), ramp.data(), VKL_DATA_SHARED_BUFFER);
+  buffers.addConstant(leafLevel,
+                      vec3i(2 * leafRes, 0, 0),
+                      rampCopy.data(),
+                      VKL_DATA_SHARED_BUFFER);
+  VKLVolume volume = buffers.createVolume(VKL_FILTER_NEAREST);
+
+  std::vector<vkl_vec3f> positions;
+  std::vector<float> expected;
+  for (int x = 0; x < 3 * leafRes; x += 3) {
+    const vkl_vec3f p = {x + 0.5f, 1.5f, 2.5f};
+    positions.push_back(p);
+    expected.push_back(vklComputeSample(volume, &p));
+  }
+
+  vklSetBool(volume, "collapseUniformLeaves", true);
+  vklSetBool(volume, "deduplicateLeaves", true);
+  vklCommit(volume);
+
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+  CHECK(valueRange.lower == 0.f);
+  CHECK(valueRange.upper == static_cast<float>(numVoxels - 1));
+
+  // The collapsed leaf is a tile now, and the last leaf reads the buffer of
+  // the second one, so changing their buffers does not affect samples.
+  std::fill(uniform.begin(), uniform.end(), -1.f);
+  std::fill(rampCopy.begin(), rampCopy.end(), -2.f);
+
+  for (size_t i = 0; i < positions.size(); ++i) {
+    INFO("x = " << positions[i].x);
+    CHECK(vklComputeSample(volume, &positions[i]) == expected[i]);
+  }
+
+  // Without compaction, every leaf reads its own buffer.
+  vklSetBool(volume, "collapseUniformLeaves", false);
+  vklSetBool(volume, "deduplicateLeaves", false);
+  vklCommit(volume);
+
+  for (size_t i = 0; i < positions.size(); ++i) {
+    INFO("x = " << positions[i].x);
+    const int leaf = static_cast<int>(positions[i].x) / leafRes;
+    const float value = leaf == 0 ? -1.f : (leaf == 1 ? expected[i] : -2.f);
+    CHECK(vklComputeSample(volume, &positions[i]) == value);
+  }
+
+  vklRelease(volume);
+}
+
+TEST_CASE("VDB volume tricubic filter", "[volume_sampling]")
+{
+  init_driver();
+
+  const uint32_t leafLevel = vklVdbNumLevels() - 1;
+  const uint32_t numVoxels = vklVdbLevelNumVoxels(leafLevel);
+  const int leafRes        = vklVdbLevelRes(leafLevel);
+
+  // Two adjacent leaves with a linear ramp in x, which the B-spline filter
+  // reproduces both inside a leaf and across the leaf boundary.
+  std::vector<std::vector<float>> values(2, std::vector<float>(numVoxels));
+  for (int l = 0; l < 2; ++l) {
+    for (int x = 0; x < leafRes; ++x)
+      for (int y = 0; y < leafRes; ++y)
+        for (int z = 0; z < leafRes; ++z)
+          values[l][vklVdb3DToLinear(leafLevel, x, y, z)] =
+              static_cast<float>(l * leafRes + x);
+  }
+
+  vdb_util::VdbVolumeBuffers<VKL_FLOAT> buffers;
+  buffers.addConstant(leafLevel, vec3i(0), values[0].data(), VKL_DATA_DEFAULT);
+  buffers.addConstant(
+      leafLevel, vec3i(leafRes, 0, 0), values[1].data(), VKL_DATA_DEFAULT);
+  VKLVolume volume = buffers.createVolume(VKL_FILTER_TRICUBIC);
+
+  const float yz = 0.5f * leafRes + 0.25f;
+  for (float x : {2.25f, 0.5f * leafRes, leafRes - 0.5f, leafRes + 0.75f}) {
+    INFO("x = " << x);
+    const vkl_vec3f p = {x, yz, yz};
+    CHECK(vklComputeSample(volume, &p) == Approx(x));
+
+    const vkl_vec3f gradient = vklComputeGradient(volume, &p);
+    CHECK(gradient.x == Approx(1.f).margin(1e-5f));
+    CHECK(gradient.y == Approx(0.f).margin(1e-5f));
+    CHECK(gradient.z == Approx(0.f).margin(1e-5f));
+  }
+
+  vklRelease(volume);
+}
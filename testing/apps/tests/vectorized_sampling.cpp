@@ -83,6 +83,46 @@ void test_vectorized_sampling()
       }
     }
   }
+
+  SECTION("ray sampling matches scalar sampling")
+  {
+    vkl_box3f bbox = vklGetBoundingBox(vklVolume);
+
+    std::random_device rd;
+    std::mt19937 eng(rd());
+
+    std::uniform_real_distribution<float> distX(bbox.lower.x, bbox.upper.x);
+    std::uniform_real_distribution<float> distY(bbox.lower.y, bbox.upper.y);
+    std::uniform_real_distribution<float> distZ(bbox.lower.z, bbox.upper.z);
+
+    for (unsigned int numSamples = 2; numSamples < 100; numSamples += 7) {
+      // both end points are inside the volume, and so are all samples
+      const vec3f origin(distX(eng), distY(eng), distZ(eng));
+      const vec3f end(distX(eng), distY(eng), distZ(eng));
+      const vec3f direction = end - origin;
+
+      const float dt = 1.f / (numSamples - 1);
+
+      std::vector<float> samples(numSamples);
+      vklSampleRay(vklVolume,
+                   (const vkl_vec3f *)&origin,
+                   (const vkl_vec3f *)&direction,
+                   0.f,
+                   dt,
+                   numSamples,
+                   samples.data());
+
+      for (unsigned int i = 0; i < numSamples; i++) {
+        const vec3f objectCoordinates = origin + (i * dt) * direction;
+
+        float sampleTruth = vklComputeSample(
+            vklVolume, (const vkl_vec3f *)&objectCoordinates);
+
+        INFO("sample = " << i + 1 << " / " << numSamples);
+        REQUIRE(samples[i] == Approx(sampleTruth).margin(1e-4f));
+      }
+    }
+  }
 }
 
 TEST_CASE("Vectorized sampling", "[volume_sampling]")
@@ -20,12 +20,15 @@ void initializeOpenVKL()
   vklSetCurrentDriver(driver);
 }
 
+template <VKLFilter filter>
 static void scalarRandomSample(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -45,15 +48,18 @@ static void scalarRandomSample(benchmark::State &state)
   state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(scalarRandomSample);
+BENCHMARK_TEMPLATE(scalarRandomSample, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(scalarRandomSample, VKL_FILTER_TRICUBIC);
 
-template <int W>
+template <int W, VKLFilter filter>
 void vectorRandomSample(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -98,16 +104,23 @@ void vectorRandomSample(benchmark::State &state)
   state.SetItemsProcessed(state.iterations() * W);
 }
 
-BENCHMARK_TEMPLATE(vectorRandomSample, 4);
-BENCHMARK_TEMPLATE(vectorRandomSample, 8);
-BENCHMARK_TEMPLATE(vectorRandomSample, 16);
+BENCHMARK_TEMPLATE(vectorRandomSample, 4, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorRandomSample, 8, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorRandomSample, 16, VKL_FILTER_TRILINEAR);
+
+BENCHMARK_TEMPLATE(vectorRandomSample, 4, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorRandomSample, 8, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorRandomSample, 16, VKL_FILTER_TRICUBIC);
 
+template <VKLFilter filter>
 static void scalarFixedSample(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -122,15 +135,18 @@ static void scalarFixedSample(benchmark::State &state)
   state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(scalarFixedSample);
+BENCHMARK_TEMPLATE(scalarFixedSample, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(scalarFixedSample, VKL_FILTER_TRICUBIC);
 
-template <int W>
+template <int W, VKLFilter filter>
 void vectorFixedSample(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -172,16 +188,70 @@ void vectorFixedSample(benchmark::State &state)
   state.SetItemsProcessed(state.iterations() * W);
 }
 
-BENCHMARK_TEMPLATE(vectorFixedSample, 4);
-BENCHMARK_TEMPLATE(vectorFixedSample, 8);
-BENCHMARK_TEMPLATE(vectorFixedSample, 16);
+BENCHMARK_TEMPLATE(vectorFixedSample, 4, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorFixedSample, 8, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorFixedSample, 16, VKL_FILTER_TRILINEAR);
+
+BENCHMARK_TEMPLATE(vectorFixedSample, 4, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorFixedSample, 8, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorFixedSample, 16, VKL_FILTER_TRICUBIC);
+
+// samples along random rays in z, either per step with vklComputeSample() or
+// with one vklSampleRay() call per ray
+template <bool sampleRay>
+static void scalarRayMarch(benchmark::State &state)
+{
+  auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+      vec3i(128), vec3f(0.f), vec3f(1.f));
+
+  VKLVolume vklVolume = v->getVKLVolume();
+
+  vkl_box3f bbox = vklGetBoundingBox(vklVolume);
+
+  std::random_device rd;
+  pcg32_biased_float_distribution distX(rd(), 0, bbox.lower.x, bbox.upper.x);
+  pcg32_biased_float_distribution distY(rd(), 0, bbox.lower.y, bbox.upper.y);
+
+  const unsigned int numSamples = 256;
+  const float dt = (bbox.upper.z - bbox.lower.z) / (numSamples - 1);
+
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+
+  std::vector<float> samples(numSamples);
+
+  for (auto _ : state) {
+    vkl_vec3f origin{distX(), distY(), bbox.lower.z};
+
+    if (sampleRay) {
+      vklSampleRay(
+          vklVolume, &origin, &direction, 0.f, dt, numSamples, samples.data());
+    } else {
+      for (unsigned int i = 0; i < numSamples; i++) {
+        vkl_vec3f objectCoordinates{
+            origin.x, origin.y, origin.z + i * dt * direction.z};
+        samples[i] = vklComputeSample(vklVolume, &objectCoordinates);
+      }
+    }
+
+    benchmark::DoNotOptimize(samples.data());
+  }
+
+  // enables rates in report output
+  state.SetItemsProcessed(state.iterations() * numSamples);
+}
+
+BENCHMARK_TEMPLATE(scalarRayMarch, false);
+BENCHMARK_TEMPLATE(scalarRayMarch, true);
 
+template <VKLFilter filter>
 static void scalarRandomGradient(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -201,15 +271,18 @@ static void scalarRandomGradient(benchmark::State &state)
   state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(scalarRandomGradient);
+BENCHMARK_TEMPLATE(scalarRandomGradient, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(scalarRandomGradient, VKL_FILTER_TRICUBIC);
 
-template <int W>
+template <int W, VKLFilter filter>
 void vectorRandomGradient(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -262,16 +335,23 @@ void vectorRandomGradient(benchmark::State &state)
   state.SetItemsProcessed(state.iterations() * W);
 }
 
-BENCHMARK_TEMPLATE(vectorRandomGradient, 4);
-BENCHMARK_TEMPLATE(vectorRandomGradient, 8);
-BENCHMARK_TEMPLATE(vectorRandomGradient, 16);
+BENCHMARK_TEMPLATE(vectorRandomGradient, 4, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorRandomGradient, 8, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorRandomGradient, 16, VKL_FILTER_TRILINEAR);
+
+BENCHMARK_TEMPLATE(vectorRandomGradient, 4, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorRandomGradient, 8, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorRandomGradient, 16, VKL_FILTER_TRICUBIC);
 
+template <VKLFilter filter>
 static void scalarFixedGradient(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -286,15 +366,18 @@ static void scalarFixedGradient(benchmark::State &state)
   state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(scalarFixedGradient);
+BENCHMARK_TEMPLATE(scalarFixedGradient, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(scalarFixedGradient, VKL_FILTER_TRICUBIC);
 
-template <int W>
+template <int W, VKLFilter filter>
 void vectorFixedGradient(benchmark::State &state)
 {
   auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
       vec3i(128), vec3f(0.f), vec3f(1.f));
 
   VKLVolume vklVolume = v->getVKLVolume();
+  vklSetInt(vklVolume, "filter", filter);
+  vklCommit(vklVolume);
 
   vkl_box3f bbox = vklGetBoundingBox(vklVolume);
 
@@ -344,9 +427,13 @@ void vectorFixedGradient(benchmark::State &state)
   state.SetItemsProcessed(state.iterations() * W);
 }
 
-BENCHMARK_TEMPLATE(vectorFixedGradient, 4);
-BENCHMARK_TEMPLATE(vectorFixedGradient, 8);
-BENCHMARK_TEMPLATE(vectorFixedGradient, 16);
+BENCHMARK_TEMPLATE(vectorFixedGradient, 4, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorFixedGradient, 8, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(vectorFixedGradient, 16, VKL_FILTER_TRILINEAR);
+
+BENCHMARK_TEMPLATE(vectorFixedGradient, 4, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorFixedGradient, 8, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorFixedGradient, 16, VKL_FILTER_TRICUBIC);
 
 static void scalarIntervalIteratorConstruction(benchmark::State &state)
 {
@@ -530,6 +617,283 @@ BENCHMARK(scalarIntervalIteratorIterateSecond)->Threads(12)->UseRealTime();
 BENCHMARK(scalarIntervalIteratorIterateSecond)->Threads(36)->UseRealTime();
 BENCHMARK(scalarIntervalIteratorIterateSecond)->Threads(72)->UseRealTime();
 
+/*
+ * The vector interval iterator API for each calling width.
+ */
+template <int W>
+struct VectorIntervalIterator;
+
+template <>
+struct VectorIntervalIterator<4>
+{
+  using Iterator = VKLIntervalIterator4;
+  using Interval = VKLInterval4;
+
+  static void init(const int *valid,
+                   Iterator *iterator,
+                   VKLVolume volume,
+                   const vvec3fn<4> &origin,
+                   const vvec3fn<4> &direction,
+                   const vrange1fn<4> &tRange,
+                   VKLValueSelector valueSelector)
+  {
+    vklInitIntervalIterator4(valid,
+                             iterator,
+                             volume,
+                             (const vkl_vvec3f4 *)&origin,
+                             (const vkl_vvec3f4 *)&direction,
+                             (const vkl_vrange1f4 *)&tRange,
+                             valueSelector);
+  }
+
+  static void iterate(const int *valid,
+                      Iterator *iterator,
+                      Interval *interval,
+                      int *result)
+  {
+    vklIterateInterval4(valid, iterator, interval, result);
+  }
+};
+
+template <>
+struct VectorIntervalIterator<8>
+{
+  using Iterator = VKLIntervalIterator8;
+  using Interval = VKLInterval8;
+
+  static void init(const int *valid,
+                   Iterator *iterator,
+                   VKLVolume volume,
+                   const vvec3fn<8> &origin,
+                   const vvec3fn<8> &direction,
+                   const vrange1fn<8> &tRange,
+                   VKLValueSelector valueSelector)
+  {
+    vklInitIntervalIterator8(valid,
+                             iterator,
+                             volume,
+                             (const vkl_vvec3f8 *)&origin,
+                             (const vkl_vvec3f8 *)&direction,
+                             (const vkl_vrange1f8 *)&tRange,
+                             valueSelector);
+  }
+
+  static void iterate(const int *valid,
+                      Iterator *iterator,
+                      Interval *interval,
+                      int *result)
+  {
+    vklIterateInterval8(valid, iterator, interval, result);
+  }
+};
+
+template <>
+struct VectorIntervalIterator<16>
+{
+  using Iterator = VKLIntervalIterator16;
+  using Interval = VKLInterval16;
+
+  static void init(const int *valid,
+                   Iterator *iterator,
+                   VKLVolume volume,
+                   const vvec3fn<16> &origin,
+                   const vvec3fn<16> &direction,
+                   const vrange1fn<16> &tRange,
+                   VKLValueSelector valueSelector)
+  {
+    vklInitIntervalIterator16(valid,
+                              iterator,
+                              volume,
+                              (const vkl_vvec3f16 *)&origin,
+                              (const vkl_vvec3f16 *)&direction,
+                              (const vkl_vrange1f16 *)&tRange,
+                              valueSelector);
+  }
+
+  static void iterate(const int *valid,
+                      Iterator *iterator,
+                      Interval *interval,
+                      int *result)
+  {
+    vklIterateInterval16(valid, iterator, interval, result);
+  }
+};
+
+/*
+ * Iterate all intervals of packets of primary rays from a pinhole camera in
+ * front of the volume. Coherent packets cover a tile of adjacent pixels,
+ * incoherent packets random pixels across the image.
+ */
+template <int W, bool coherent>
+void vectorPrimaryRayIntervalIteration(benchmark::State &state)
+{
+  auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+      vec3i(128), vec3f(0.f), vec3f(1.f));
+
+  VKLVolume vklVolume = v->getVKLVolume();
+
+  const vkl_box3f bbox         = vklGetBoundingBox(vklVolume);
+  const vkl_range1f valueRange = vklGetValueRange(vklVolume);
+
+  // the middle half of the value range, so that some cells are culled
+  const float quarter = 0.25f * (valueRange.upper - valueRange.lower);
+  const vkl_range1f selectedRange{valueRange.lower + quarter,
+                                  valueRange.upper - quarter};
+
+  VKLValueSelector valueSelector = vklNewValueSelector(vklVolume);
+  vklValueSelectorSetRanges(valueSelector, 1, &selectedRange);
+  vklCommit(valueSelector);
+
+  // the image plane is the front face of the volume
+  const int resolution = 512;
+  const vec3f lower(bbox.lower.x, bbox.lower.y, bbox.lower.z);
+  const vec3f extent =
+      vec3f(bbox.upper.x, bbox.upper.y, bbox.upper.z) - lower;
+  const vec3f eye =
+      lower + vec3f(0.5f * extent.x, 0.5f * extent.y, -extent.z);
+
+  const int tileWidth  = W == 4 ? 2 : 4;
+  const int tileHeight = W / tileWidth;
+
+  std::random_device rd;
+  std::mt19937 eng(rd());
+  std::uniform_int_distribution<int> distTileX(0, resolution - tileWidth);
+  std::uniform_int_distribution<int> distTileY(0, resolution - tileHeight);
+  std::uniform_int_distribution<int> distPixel(0, resolution - 1);
+
+  int valid[W];
+  vvec3fn<W> origin;
+  vvec3fn<W> direction;
+  vrange1fn<W> tRange;
+
+  for (int i = 0; i < W; i++) {
+    valid[i]        = 1;
+    origin.x[i]     = eye.x;
+    origin.y[i]     = eye.y;
+    origin.z[i]     = eye.z;
+    tRange.lower[i] = 0.f;
+    tRange.upper[i] = 1000.f;
+  }
+
+  using IteratorN = VectorIntervalIterator<W>;
+
+  size_t numIntervals = 0;
+
+  for (auto _ : state) {
+    const int tileX = distTileX(eng);
+    const int tileY = distTileY(eng);
+
+    for (int i = 0; i < W; i++) {
+      const int px = coherent ? tileX + i % tileWidth : distPixel(eng);
+      const int py = coherent ? tileY + i / tileWidth : distPixel(eng);
+
+      const vec3f pixel =
+          lower + extent * vec3f((px + 0.5f) / resolution,
+                                 (py + 0.5f) / resolution,
+                                 0.f);
+      const vec3f d = normalize(pixel - eye);
+
+      direction.x[i] = d.x;
+      direction.y[i] = d.y;
+      direction.z[i] = d.z;
+    }
+
+    typename IteratorN::Iterator iterator;
+    IteratorN::init(
+        valid, &iterator, vklVolume, origin, direction, tRange, valueSelector);
+
+    typename IteratorN::Interval interval;
+    int result[W];
+
+    while (true) {
+      IteratorN::iterate(valid, &iterator, &interval, result);
+
+      int numActive = 0;
+      for (int i = 0; i < W; i++)
+        numActive += result[i];
+
+      if (numActive == 0)
+        break;
+
+      benchmark::DoNotOptimize(interval);
+      numIntervals += numActive;
+    }
+  }
+
+  vklRelease(valueSelector);
+
+  // enables rates in report output
+  state.SetItemsProcessed(state.iterations() * W);
+  state.counters["intervalsPerRay"] =
+      double(numIntervals) / (state.iterations() * W);
+}
+
+BENCHMARK_TEMPLATE(vectorPrimaryRayIntervalIteration, 4, true);
+BENCHMARK_TEMPLATE(vectorPrimaryRayIntervalIteration, 8, true);
+BENCHMARK_TEMPLATE(vectorPrimaryRayIntervalIteration, 16, true);
+
+BENCHMARK_TEMPLATE(vectorPrimaryRayIntervalIteration, 4, false);
+BENCHMARK_TEMPLATE(vectorPrimaryRayIntervalIteration, 8, false);
+BENCHMARK_TEMPLATE(vectorPrimaryRayIntervalIteration, 16, false);
+
+template <bool exactHits>
+static void scalarHitIteration(benchmark::State &state)
+{
+  auto v = ospcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+      vec3i(128), vec3f(0.f), vec3f(1.f));
+
+  VKLVolume vklVolume = v->getVKLVolume();
+  vklSetBool(vklVolume, "exactHits", exactHits);
+  vklCommit(vklVolume);
+
+  vkl_box3f bbox         = vklGetBoundingBox(vklVolume);
+  vkl_range1f valueRange = vklGetValueRange(vklVolume);
+
+  std::vector<float> isoValues;
+
+  for (int i = 1; i < 8; i++) {
+    isoValues.push_back(valueRange.lower +
+                        i / 8.f * (valueRange.upper - valueRange.lower));
+  }
+
+  VKLValueSelector valueSelector = vklNewValueSelector(vklVolume);
+  vklValueSelectorSetValues(valueSelector, isoValues.size(), isoValues.data());
+  vklCommit(valueSelector);
+
+  std::random_device rd;
+  pcg32_biased_float_distribution distX(rd(), 0, bbox.lower.x, bbox.upper.x);
+  pcg32_biased_float_distribution distY(rd(), 0, bbox.lower.y, bbox.upper.y);
+
+  vkl_vec3f direction{0.f, 0.f, 1.f};
+  vkl_range1f tRange{0.f, 1000.f};
+
+  size_t numHits = 0;
+
+  for (auto _ : state) {
+    vkl_vec3f origin{distX(), distY(), -1.f};
+
+    VKLHitIterator iterator;
+    vklInitHitIterator(
+        &iterator, vklVolume, &origin, &direction, &tRange, valueSelector);
+
+    VKLHit hit;
+
+    while (vklIterateHit(&iterator, &hit)) {
+      benchmark::DoNotOptimize(hit);
+      numHits++;
+    }
+  }
+
+  vklRelease(valueSelector);
+
+  // enables rates in report output
+  state.SetItemsProcessed(state.iterations());
+  state.counters["hitsPerRay"] = double(numHits) / state.iterations();
+}
+
+BENCHMARK_TEMPLATE(scalarHitIteration, false);
+BENCHMARK_TEMPLATE(scalarHitIteration, true);
+
 // based on BENCHMARK_MAIN() macro from benchmark.h
 int main(int argc, char **argv)
 {
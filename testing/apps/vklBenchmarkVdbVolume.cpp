@@ -1,6 +1,8 @@
 // Copyright 2020 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include "../common/simd.h"
 #include "benchmark/benchmark.h"
@@ -48,6 +50,7 @@ static void scalarRandomSample(benchmark::State &state)
 
 BENCHMARK_TEMPLATE(scalarRandomSample, VKL_FILTER_NEAREST);
 BENCHMARK_TEMPLATE(scalarRandomSample, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(scalarRandomSample, VKL_FILTER_TRICUBIC);
 
 template <int W, VKLFilter filter>
 void vectorRandomSample(benchmark::State &state)
@@ -115,6 +118,10 @@ BENCHMARK_TEMPLATE(vectorRandomSample, 4, VKL_FILTER_TRILINEAR);
 BENCHMARK_TEMPLATE(vectorRandomSample, 8, VKL_FILTER_TRILINEAR);
 BENCHMARK_TEMPLATE(vectorRandomSample, 16, VKL_FILTER_TRILINEAR);
 
+BENCHMARK_TEMPLATE(vectorRandomSample, 4, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorRandomSample, 8, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorRandomSample, 16, VKL_FILTER_TRICUBIC);
+
 template <VKLFilter filter>
 static void scalarFixedSample(benchmark::State &state)
 {
@@ -138,6 +145,7 @@ static void scalarFixedSample(benchmark::State &state)
 
 BENCHMARK_TEMPLATE(scalarFixedSample, VKL_FILTER_NEAREST);
 BENCHMARK_TEMPLATE(scalarFixedSample, VKL_FILTER_TRILINEAR);
+BENCHMARK_TEMPLATE(scalarFixedSample, VKL_FILTER_TRICUBIC);
 
 template <int W, VKLFilter filter>
 void vectorFixedSample(benchmark::State &state)
@@ -202,6 +210,10 @@ BENCHMARK_TEMPLATE(vectorFixedSample, 4, VKL_FILTER_TRILINEAR);
 BENCHMARK_TEMPLATE(vectorFixedSample, 8, VKL_FILTER_TRILINEAR);
 BENCHMARK_TEMPLATE(vectorFixedSample, 16, VKL_FILTER_TRILINEAR);
 
+BENCHMARK_TEMPLATE(vectorFixedSample, 4, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorFixedSample, 8, VKL_FILTER_TRICUBIC);
+BENCHMARK_TEMPLATE(vectorFixedSample, 16, VKL_FILTER_TRICUBIC);
+
 template <VKLFilter filter>
 static void scalarIntervalIteratorConstruction(benchmark::State &state)
 {
@@ -386,6 +398,71 @@ BENCHMARK_TEMPLATE(scalarIntervalIteratorIterateFirst, VKL_FILTER_TRILINEAR)
     ->Threads(72)
     ->UseRealTime();
 
+static void commitVolume(benchmark::State &state)
+{
+  const uint64_t numLeaves = state.range(0);
+  const uint32_t leafLevel = vklVdbNumLevels() - 1;
+  const int leafRes        = vklVdbLevelRes(leafLevel);
+
+  // Leaves form a dense cube, but are passed in random order.
+  const int n = static_cast<int>(std::ceil(std::cbrt(numLeaves)));
+  std::vector<vec3i> origin(numLeaves);
+  for (uint64_t i = 0; i < numLeaves; ++i) {
+    origin[i] = leafRes * vec3i(i % n, (i / n) % n, i / (n * n));
+  }
+  std::shuffle(origin.begin(), origin.end(), std::mt19937(0));
+
+  std::vector<uint32_t> level(numLeaves, leafLevel);
+  std::vector<uint32_t> format(numLeaves, VKL_VDB_FORMAT_CONSTANT);
+
+  // All leaves share the same data.
+  std::vector<float> leaf(vklVdbLevelNumVoxels(leafLevel));
+  for (size_t i = 0; i < leaf.size(); ++i) {
+    leaf[i] = static_cast<float>(i);
+  }
+  VKLData leafData = vklNewData(
+      leaf.size(), VKL_FLOAT, leaf.data(), VKL_DATA_SHARED_BUFFER);
+  std::vector<VKLData> data(numLeaves, leafData);
+
+  VKLVolume volume = vklNewVolume("vdb");
+  vklSetInt(volume, "type", VKL_FLOAT);
+
+  VKLData dataLevel = vklNewData(numLeaves, VKL_UINT, level.data());
+  VKLData dataOrigin = vklNewData(numLeaves, VKL_VEC3I, origin.data());
+  VKLData dataFormat = vklNewData(numLeaves, VKL_UINT, format.data());
+  VKLData dataData   = vklNewData(numLeaves, VKL_DATA, data.data());
+  vklSetData(volume, "level", dataLevel);
+  vklSetData(volume, "origin", dataOrigin);
+  vklSetData(volume, "format", dataFormat);
+  vklSetData(volume, "data", dataData);
+  vklRelease(dataLevel);
+  vklRelease(dataOrigin);
+  vklRelease(dataFormat);
+  vklRelease(dataData);
+
+  for (auto _ : state) {
+    vklCommit(volume);
+  }
+
+  VKLObserver observer = vklNewObserver(volume, "MemoryUsage");
+  state.counters["bytesUsed"] =
+      *static_cast<const uint64_t *>(vklMapObserver(observer));
+  vklUnmapObserver(observer);
+  vklRelease(observer);
+
+  vklRelease(volume);
+  vklRelease(leafData);
+
+  // enables rates in report output
+  state.SetItemsProcessed(state.iterations() * numLeaves);
+}
+
+BENCHMARK(commitVolume)
+    ->RangeMultiplier(8)
+    ->Range(1 << 12, 1 << 21)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
 // based on BENCHMARK_MAIN() macro from benchmark.h
 int main(int argc, char **argv)
 {
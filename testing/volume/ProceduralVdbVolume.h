@@ -159,6 +159,7 @@ namespace openvkl {
     };
 
     using WaveletVdbVolume = ProceduralVdbVolume<getWaveletValue<float>>;
+    using ZVdbVolume       = ProceduralVdbVolume<getZValue>;
 
   }  // namespace testing
 }  // namespace openvkl
@@ -9,6 +9,8 @@
 
 #include <openvdb/openvdb.h>
 
+#include "ospcommon/tasking/parallel_for.h"
+
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -64,7 +66,8 @@ namespace openvkl {
 
         static void visit(const VdbNodeType &vdbNode,
                           VdbVolumeBuffers<VKL_FLOAT> &volumeBuffers,
-                          std::vector<Deferred> &deferred)
+                          std::vector<Deferred> &deferred,
+                          bool deferLeaves)
         {
           for (auto it = vdbNode.cbeginValueOn(); it; ++it) {
             const auto &coord = it.getCoord();
@@ -73,7 +76,8 @@ namespace openvkl {
           }
 
           for (auto it = vdbNode.cbeginChildOn(); it; ++it)
-            Builder<ChildNodeType>::visit(*it, volumeBuffers, deferred);
+            Builder<ChildNodeType>::visit(
+                *it, volumeBuffers, deferred, deferLeaves);
         }
       };
 
@@ -93,7 +97,8 @@ namespace openvkl {
 
         static void visit(const VdbNodeType &vdbNode,
                           VdbVolumeBuffers<VKL_FLOAT> &volumeBuffers,
-                          std::vector<Deferred> &deferred)
+                          std::vector<Deferred> &deferred,
+                          bool deferLeaves)
         {
           const uint32_t storageRes = vklVdbLevelStorageRes(level);
           const uint32_t childRes   = vklVdbLevelRes(nextLevel);
@@ -107,10 +112,9 @@ namespace openvkl {
           for (uint32_t x = 0; x < storageRes; ++x)
             for (uint32_t y = 0; y < storageRes; ++y)
               for (uint32_t z = 0; z < storageRes; ++z, ++vIdx) {
-                const bool isTile  = vdbNode.isValueMaskOn(vIdx);
-                const bool isChild = vdbNode.isChildMaskOn(vIdx);
-                const bool isDeferred =
-                    isChild && (deferred.capacity() > deferred.size());
+                const bool isTile     = vdbNode.isValueMaskOn(vIdx);
+                const bool isChild    = vdbNode.isChildMaskOn(vIdx);
+                const bool isDeferred = isChild && deferLeaves;
 
                 if (!(isTile || isChild))
                   continue;
@@ -306,8 +310,16 @@ namespace openvkl {
         deferred.resize(newSize);
       }
 
+      /*
+       * Import the tree in parallel over the children of the root node.
+       * Each task fills its own VdbVolumeBuffers, and we merge them in order
+       * so that the node order does not depend on scheduling. Leaf data is
+       * shared with the OpenVDB tree, not copied.
+       */
       void loadFromGrid(openvdb::FloatGrid::Ptr vdb, bool deferLeaves = false)
       {
+        using TopNodeType = openvdb::FloatTree::RootNodeType::ChildNodeType;
+
         const size_t numTiles  = vdb->tree().activeTileCount();
         const size_t numLeaves = vdb->tree().leafCount();
         buffers->reserve(numTiles + numLeaves);
@@ -316,10 +328,28 @@ namespace openvkl {
 
         loadTransform();
 
+        std::vector<const TopNodeType *> topNodes;
         const auto &root = vdb->tree().root();
         for (auto it = root.cbeginChildOn(); it; ++it)
-          Builder<openvdb::FloatTree::RootNodeType::ChildNodeType>::visit(
-              *it, *buffers, deferred);
+          topNodes.push_back(&*it);
+
+        std::vector<std::unique_ptr<VdbVolumeBuffers<VKL_FLOAT>>> localBuffers(
+            topNodes.size());
+        std::vector<std::vector<Deferred>> localDeferred(topNodes.size());
+
+        ospcommon::tasking::parallel_for(topNodes.size(), [&](size_t i) {
+          localBuffers[i].reset(new VdbVolumeBuffers<VKL_FLOAT>);
+          Builder<TopNodeType>::visit(
+              *topNodes[i], *localBuffers[i], localDeferred[i], deferLeaves);
+        });
+
+        for (size_t i = 0; i < topNodes.size(); ++i) {
+          const size_t first = buffers->append(*localBuffers[i]);
+          for (Deferred d : localDeferred[i]) {
+            d.index += first;
+            deferred.push_back(d);
+          }
+        }
       }
 
      private:
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include "openvkl/openvkl.h"
 #include "openvkl/vdb.h"
@@ -49,18 +50,31 @@ namespace openvkl {
       std::vector<vec3i> origin;
 
       /*
-       * The node format. This can be VKL_VDB_FORMAT_TILE or
-       * VKL_VDB_FORMAT_CONSTANT at this point.
+       * The node format. This can be VKL_VDB_FORMAT_TILE,
+       * VKL_VDB_FORMAT_CONSTANT, VKL_VDB_FORMAT_DENSE, or VKL_VDB_FORMAT_TUV.
        */
       std::vector<VKLVdbLeafFormat> format;
 
       /*
        * The actual node data. Tiles have exactly one value,
        * constant nodes have vklVdbLevelRes(level)^3 =
-       * vklVdbLevelNumVoxels(level) values.
+       * vklVdbLevelNumVoxels(level) values. Dense nodes have numTimesteps
+       * values per voxel, and TUV nodes have as many values as times.
        */
       std::vector<VKLData> data;
 
+      /*
+       * The number of time steps for dense nodes, 0 otherwise.
+       */
+      std::vector<uint32_t> numTimesteps;
+
+      /*
+       * Per voxel value index ranges and per value times for TUV nodes,
+       * nullptr otherwise.
+       */
+      std::vector<VKLData> tuvIndices;
+      std::vector<VKLData> tuvTimes;
+
      public:
       /*
        * Construction / destruction.
@@ -118,10 +132,19 @@ namespace openvkl {
       {
         for (VKLData d : data)
           vklRelease(d);
+        for (VKLData d : tuvIndices)
+          if (d)
+            vklRelease(d);
+        for (VKLData d : tuvTimes)
+          if (d)
+            vklRelease(d);
         level.clear();
         origin.clear();
         format.clear();
         data.clear();
+        numTimesteps.clear();
+        tuvIndices.clear();
+        tuvTimes.clear();
       }
 
       /*
@@ -140,6 +163,9 @@ namespace openvkl {
         origin.reserve(numNodes);
         format.reserve(numNodes);
         data.reserve(numNodes);
+        numTimesteps.reserve(numNodes);
+        tuvIndices.reserve(numNodes);
+        tuvTimes.reserve(numNodes);
       }
 
       /*
@@ -148,11 +174,9 @@ namespace openvkl {
        */
       size_t addTile(uint32_t level, const vec3i &origin, const void *ptr)
       {
-        const size_t index = numNodes();
-        this->level.push_back(level);
-        this->origin.push_back(origin);
-        format.push_back(VKL_VDB_FORMAT_TILE);
-        data.push_back(vklNewData(1, FieldType, ptr, VKL_DATA_DEFAULT));
+        const size_t index = addNode(level, origin);
+        format.at(index)   = VKL_VDB_FORMAT_TILE;
+        data.at(index)     = vklNewData(1, FieldType, ptr, VKL_DATA_DEFAULT);
         return index;
       }
 
@@ -165,15 +189,73 @@ namespace openvkl {
                          const void *ptr,
                          VKLDataCreationFlags flags)
       {
-        const size_t index = numNodes();
-        this->level.push_back(level);
-        this->origin.push_back(origin);
-        format.push_back(VKL_VDB_FORMAT_INVALID);
-        data.push_back(nullptr);
+        const size_t index = addNode(level, origin);
         makeConstant(index, ptr, flags);
         return index;
       }
 
+      /*
+       * Add a new temporally structured (dense) node, with numTimesteps
+       * values per voxel.
+       * Returns the new node's index.
+       */
+      size_t addTemporallyStructured(uint32_t level,
+                                     const vec3i &origin,
+                                     uint32_t numTimesteps,
+                                     const void *ptr,
+                                     VKLDataCreationFlags flags)
+      {
+        const size_t index = addNode(level, origin);
+        format.at(index)   = VKL_VDB_FORMAT_DENSE;
+        data.at(index)     = vklNewData(
+            vklVdbLevelNumVoxels(level) * numTimesteps, FieldType, ptr, flags);
+        this->numTimesteps.at(index) = numTimesteps;
+        return index;
+      }
+
+      /*
+       * Add a new temporally unstructured (TUV) node. indices has
+       * vklVdbLevelNumVoxels(level)+1 entries; the values and times of voxel
+       * v are in the range [indices[v], indices[v+1]).
+       * Returns the new node's index.
+       */
+      size_t addTemporallyUnstructured(uint32_t level,
+                                       const vec3i &origin,
+                                       const uint32_t *indices,
+                                       const float *times,
+                                       const void *ptr)
+      {
+        const size_t numVoxels = vklVdbLevelNumVoxels(level);
+        const size_t numValues = indices[numVoxels];
+        const size_t index     = addNode(level, origin);
+        format.at(index)       = VKL_VDB_FORMAT_TUV;
+        data.at(index) =
+            vklNewData(numValues, FieldType, ptr, VKL_DATA_DEFAULT);
+        tuvIndices.at(index) =
+            vklNewData(numVoxels + 1, VKL_UINT, indices, VKL_DATA_DEFAULT);
+        tuvTimes.at(index) =
+            vklNewData(numValues, VKL_FLOAT, times, VKL_DATA_DEFAULT);
+        return index;
+      }
+
+      /*
+       * Move all nodes from other to the end of this object, and leave other
+       * empty. The transform of other is ignored.
+       * Returns the index of the first node moved.
+       */
+      size_t append(VdbVolumeBuffers &other)
+      {
+        const size_t first = numNodes();
+        appendVector(level, other.level);
+        appendVector(origin, other.origin);
+        appendVector(format, other.format);
+        appendVector(data, other.data);
+        appendVector(numTimesteps, other.numTimesteps);
+        appendVector(tuvIndices, other.tuvIndices);
+        appendVector(tuvTimes, other.tuvTimes);
+        return first;
+      }
+
       /*
        * Change the given node to a constant node.
        * This is useful for deferred loading.
@@ -198,7 +280,7 @@ namespace openvkl {
         vklSetInt(volume, "type", FieldType);
         vklSetInt(volume, "filter", filter);
         vklSetInt(volume, "maxSamplingDepth", vklVdbNumLevels() - 1);
-        vklSetInt(volume, "maxIteratorDepth", 3);
+        vklSetInt(volume, "maxIteratorDepth", vklVdbNumLevels() - 1);
         vklSetData(volume,
                    "indexToObject",
                    vklNewData(12, VKL_FLOAT, indexToObject, VKL_DATA_DEFAULT));
@@ -228,9 +310,67 @@ namespace openvkl {
             "data",
             vklNewData(numNodes, VKL_DATA, data.data(), VKL_DATA_DEFAULT));
 
+        const bool hasDense =
+            std::find(format.begin(), format.end(), VKL_VDB_FORMAT_DENSE) !=
+            format.end();
+        if (hasDense) {
+          vklSetData(volume,
+                     "temporallyStructuredNumTimesteps",
+                     vklNewData(numNodes,
+                                VKL_UINT,
+                                numTimesteps.data(),
+                                VKL_DATA_DEFAULT));
+        }
+
+        const bool hasTuv =
+            std::find(format.begin(), format.end(), VKL_VDB_FORMAT_TUV) !=
+            format.end();
+        if (hasTuv) {
+          vklSetData(volume,
+                     "temporallyUnstructuredIndices",
+                     vklNewData(numNodes,
+                                VKL_DATA,
+                                tuvIndices.data(),
+                                VKL_DATA_DEFAULT));
+          vklSetData(volume,
+                     "temporallyUnstructuredTimes",
+                     vklNewData(numNodes,
+                                VKL_DATA,
+                                tuvTimes.data(),
+                                VKL_DATA_DEFAULT));
+        }
+
         vklCommit(volume);
         return volume;
       }
+
+     private:
+      /*
+       * Append an empty node to all buffers.
+       */
+      size_t addNode(uint32_t level, const vec3i &origin)
+      {
+        const size_t index = numNodes();
+        this->level.push_back(level);
+        this->origin.push_back(origin);
+        format.push_back(VKL_VDB_FORMAT_INVALID);
+        data.push_back(nullptr);
+        numTimesteps.push_back(0);
+        tuvIndices.push_back(nullptr);
+        tuvTimes.push_back(nullptr);
+        return index;
+      }
+
+      /*
+       * Move the elements of src to the end of dst. Ownership of data
+       * handles moves with them.
+       */
+      template <typename T>
+      static void appendVector(std::vector<T> &dst, std::vector<T> &src)
+      {
+        dst.insert(dst.end(), src.begin(), src.end());
+        src.clear();
+      }
     };
 
   }  // namespace vdb_util